@@ -4,11 +4,29 @@
 /* Encoder HAL + Service */
 #include "Encoder/encoder_hal.hpp"
 #include "Encoder/encoder_service.hpp"
+#include "Encoder/encoder_sampling_group.hpp"
+#include "Encoder/sample_event.hpp"
+#include "Encoder/encoder_dma.hpp"
 
 /* Motor */
 #include "Motor/Motor.hpp"
+#include "Motor/motor_monitor.hpp"
 #include "H_Bridge/HBridge_hal.hpp"
 
+/* Speed controller */
+#include "PID.hpp"
+
+/* Runtime commands */
+#include "Command/command_parser.hpp"
+#include "Encoder/encoder_trace.hpp"
+
+/* Calibration and tuning in flash */
+#include "Flash/flash_storage.hpp"
+#include "Params/param_store.hpp"
+
+/* CPU load accounting */
+#include "Profiler/cpu_profiler.hpp"
+
 /* ---------------------------
    Pins configuration
 --------------------------- */
@@ -16,24 +34,150 @@
 #define MOTOR_A_PIN2 3
 #define MOTOR_A_PWM  4
 
+#define ENCODER_COUNT 2
+
+/* ---------------------------
+   Telemetry state (command T)
+--------------------------- */
+struct Telemetry {
+    bool enabled;
+    uint32_t every;         // Print every N samples
+    uint32_t sinceLast;
+};
+
+/* ---------------------------
+   Apply one command between control ticks
+--------------------------- */
+static void applyCommand(const Command& cmd, Motor& motor, MotorPID& pid, MotorMonitor& monitor,
+                         EncoderService* const services[ENCODER_COUNT],
+                         ParamStore& params, Telemetry& telemetry) {
+    switch (cmd.type) {
+        case CommandType::SET_SPEED:
+            if (cmd.index != 0) break;      // Only motor A is driven
+            if (cmd.args[0] > MAX_RPM || cmd.args[0] < -MAX_RPM) break;
+            pid.SetSpeedRPM(cmd.args[0] < 0.0f ? -cmd.args[0] : cmd.args[0], cmd.args[0] >= 0.0f);
+            printf("OK S %u %.2f\n", cmd.index, cmd.args[0]);
+            return;
+
+        case CommandType::SET_GAINS:
+            if (cmd.index != 0) break;
+            if (!(cmd.args[0] >= 0.0f && cmd.args[1] >= 0.0f && cmd.args[2] >= 0.0f)) break;
+            pid.SetGains(cmd.args[0], cmd.args[1], cmd.args[2]);
+            params.params_get().motor[cmd.index].kp = cmd.args[0];
+            params.params_get().motor[cmd.index].ki = cmd.args[1];
+            params.params_get().motor[cmd.index].kd = cmd.args[2];
+            printf("OK G %u %.4f %.4f %.4f\n", cmd.index, cmd.args[0], cmd.args[1], cmd.args[2]);
+            return;
+
+        case CommandType::TELEMETRY:
+            if (cmd.args[0] >= static_cast<float>(UINT32_MAX)) break;
+            telemetry.enabled = (cmd.index != 0);
+            if (cmd.args[0] >= 1.0f) telemetry.every = static_cast<uint32_t>(cmd.args[0]);
+            telemetry.sinceLast = 0;
+            printf("OK T %u %lu\n", telemetry.enabled ? 1u : 0u, (unsigned long)telemetry.every);
+            return;
+
+        case CommandType::QUERY:
+            if (cmd.index >= ENCODER_COUNT) break;
+            printf("Q %u %.2f %.2f %.2f %.2f\n", cmd.index,
+                   services[cmd.index]->encoder_getRPM(),
+                   services[cmd.index]->encoder_getSpeedCmS(),
+                   services[cmd.index]->encoder_getDistanceCm(),
+                   services[cmd.index]->encoder_getRotations());
+            return;
+
+        case CommandType::DUMP_TRACE:
+#if ENCODER_TRACE_ENABLE
+            EncoderTrace::trace_dump();
+            return;
+#else
+            break;
+#endif
+
+        case CommandType::SET_CALIBRATION: {
+            // cpr must fit the uint32_t it is converted to
+            if (cmd.index >= ENCODER_COUNT || cmd.args[0] < 1.0f || cmd.args[0] >= static_cast<float>(UINT32_MAX) ||
+                cmd.args[1] <= 0.0f) break;
+            EncoderParams& enc = params.params_get().encoder[cmd.index];
+            enc.cpr = static_cast<uint32_t>(cmd.args[0]);
+            enc.wheelRadiusCm = cmd.args[1];
+            enc.inverted = (cmd.args[2] != 0.0f) ? 1 : 0;
+            services[cmd.index]->encoder_setCalibration(enc.cpr, enc.wheelRadiusCm, enc.inverted != 0);
+            printf("OK C %u %lu %.3f %u\n", cmd.index, (unsigned long)enc.cpr, enc.wheelRadiusCm, enc.inverted);
+            return;
+        }
+
+        case CommandType::SAVE_PARAMS: {
+            // May erase a flash sector: IRQs stop for tens of ms. The
+            // bridge is cut first so the wheel coasts rather than being
+            // driven unsupervised, then the last duty is restored so the
+            // monitor judges this tick's sample against it.
+            float duty = motor.getCommand();
+            motor.stop();
+            bool saved = params.params_save();
+            motor.setSpeed(duty);
+            if (!saved) break;
+            printf("OK W %lu\n", (unsigned long)params.params_getSequence());
+            return;
+        }
+
+        case CommandType::CLEAR_FAULT:
+            if (cmd.index != 0) break;
+            // Restart from rest: a new S command is needed to move again
+            printf("OK F %u %s\n", cmd.index, MotorMonitor::monitor_faultName(monitor.monitor_getFault()));
+            monitor.monitor_clear();
+            pid.Reset();
+            return;
+
+        default:
+            break;
+    }
+    printf("ERR\n");
+}
+
 int main() {
     stdio_init_all();
-    sleep_ms(2000);  // wait for Serial monitor
+
+    /* ---------------------------
+       Parameters: newest record in flash, or defaults
+    --------------------------- */
+    uint32_t bootUs = time_us_32();
+    FlashStorage flash;
+    ParamStore params(flash);
+    bool stored = params.params_load();
+    uint32_t loadUs = time_us_32() - bootUs;
+    const ParamBlock& cfg = params.params_get();
 
     printf("Starting Motor + Dual Encoder Closed-loop Test...\n");
+    printf("Params | %s (seq %lu) | Loaded in %lu us\n", stored ? "Flash" : "Defaults",
+           (unsigned long)params.params_getSequence(), (unsigned long)loadUs);
 
     /* ---------------------------
        Encoder initialization
     --------------------------- */
     EncoderHAL encoder1(ENCODER1_PIN_A, ENCODER1_PIN_B);
     EncoderHAL encoder2(ENCODER2_PIN_A, ENCODER2_PIN_B);
+#if ENCODER_CAPTURE_DMA
+    static EncoderDMA encoderDma;        // Large sample buffers: keep off the stack
+    encoder1.encoder_init(EncoderMode::DMA);
+    encoder2.encoder_init(EncoderMode::DMA);
+    encoderDma.encoder_dmaStart();
+#else
     encoder1.encoder_init();
     encoder2.encoder_init();
+    EncoderHAL::encoder_startHybrid();   // Poll instead of IRQs at high edge rates
+#endif
 
     EncoderService service1(encoder1);
     EncoderService service2(encoder2);
-    service1.encoder_start();
-    service2.encoder_start();
+    service1.encoder_setCalibration(cfg.encoder[0].cpr, cfg.encoder[0].wheelRadiusCm, cfg.encoder[0].inverted != 0);
+    service2.encoder_setCalibration(cfg.encoder[1].cpr, cfg.encoder[1].wheelRadiusCm, cfg.encoder[1].inverted != 0);
+
+    // Both wheels sampled at the same instant by one hardware alarm
+    EncoderSamplingGroup samplingGroup;
+    samplingGroup.group_add(service1);
+    samplingGroup.group_add(service2);
+    samplingGroup.group_start();
 
     /* ---------------------------
        Motor initialization
@@ -42,56 +186,147 @@ int main() {
     Motor motorA(hbridgeA);
     motorA.init();
 
+    // Stall, runaway, reversed wiring and encoder loss: cuts hbridgeA
+    MotorMonitor monitorA(motorA, hbridgeA, encoder1, service1);
+
     /* ---------------------------
        Closed-loop variables
     --------------------------- */
     float targetRPM = 120.0f; // Desired motor speed
-    float Kp = 0.007f;        // Simple proportional gain (tune experimentally)
+
+    // Gains in RPM units from the parameter block (defaults in PID_config.hpp)
+    MotorPID::PIDINPUT pidIn;
+    pidIn.kp = cfg.motor[0].kp;
+    pidIn.ki = cfg.motor[0].ki;
+    pidIn.kd = cfg.motor[0].kd;
+    pidIn.dt = ENCODER_SAMPLE_PERIOD_MS / 1000.0f;  // Matches the EncoderService update period
+    pidIn.expected_speed = targetRPM;
+    pidIn.kff = cfg.motor[0].kff;
+    pidIn.d_filter_tau = cfg.motor[0].dFilterTau;
+    pidIn.kaw = cfg.motor[0].kaw;
+    pidIn.slew_rate = cfg.motor[0].slewRate;
+
+    MotorPID pid(&pidIn);
     float motorOutput = 0.0f;
 
+    /* ---------------------------
+       Runtime command interface
+    --------------------------- */
+    CommandParser commands;
+    EncoderService* const services[ENCODER_COUNT] = {&service1, &service2};
+    Telemetry telemetry = {true, 1, 0};
+
+#if CPU_PROFILER_ENABLE
+    CpuProfiler::profiler_reset();      // Windows start with the control loop
+#endif
+
+    uint32_t sampleSeq = SampleEvent::event_getSequence();
+    uint32_t samplesSinceReport = 0;
+
     while (true) {
+        /* ---------------------------
+           Sleep until the next encoder sample
+        --------------------------- */
+        SampleEvent::event_wait(sampleSeq);
+
+        PROFILE_ENTER(CONTROL_LOOP);
+
+        /* ---------------------------
+           Apply received commands at the tick boundary
+        --------------------------- */
+        commands.cmd_pollStdio();
+        Command cmd;
+        while (commands.cmd_pop(cmd)) {
+            applyCommand(cmd, motorA, pid, monitorA, services, params, telemetry);
+        }
+
+        /* ---------------------------
+           Supervise the last period before driving again
+        --------------------------- */
+        if (monitorA.monitor_tick()) {
+            printf("FAULT %s | Motor 0 | Tick %lu | Duty %.2f | RPM %.2f\n",
+                   MotorMonitor::monitor_faultName(monitorA.monitor_getFault()),
+                   (unsigned long)monitorA.monitor_getTripTick(),
+                   motorOutput, service1.encoder_getRPM());
+        }
+
         /* ---------------------------
            Read encoder RPM
         --------------------------- */
         float currentRPM = service1.encoder_getRPM();
 
         /* ---------------------------
-           Simple proportional control
+           PID speed control, frozen while a fault is latched
         --------------------------- */
-        float error = targetRPM - currentRPM;
-        motorOutput += Kp * error;
-
-        // Limit output to [-1.0, 1.0]
-        if (motorOutput > 1.0f) motorOutput = 1.0f;
-        if (motorOutput < -1.0f) motorOutput = -1.0f;
+        if (monitorA.monitor_getFault() == MotorFault::NONE) {
+            motorOutput = pid.UpdateThrottle(currentRPM);
+        } else {
+            motorOutput = 0.0f;
+        }
 
         /* ---------------------------
-           Set motor speed
+           Set motor speed (kept stopped by the lockout after a fault)
         --------------------------- */
         motorA.setSpeed(motorOutput);
 
+        PROFILE_EXIT();
+        PROFILE_ENTER(TELEMETRY_IO);
+
+        /* ---------------------------
+           Trace dump, a few lines per tick; periodic output waits
+           so the dump block stays contiguous
+        --------------------------- */
+#if ENCODER_TRACE_ENABLE
+        bool dumping = EncoderTrace::trace_dumpStep();
+#else
+        bool dumping = false;
+#endif
+
         /* ---------------------------
            Read and print encoder data
         --------------------------- */
-        int32_t ticks1 = encoder1.encoder_getTicks();
-        float rpm1   = service1.encoder_getRPM();
-        float speed1 = service1.encoder_getSpeedCmS();
-        float dist1  = service1.encoder_getDistanceCm();
-        float rot1   = service1.encoder_getRotations();
+        if (!dumping && telemetry.enabled && ++telemetry.sinceLast >= telemetry.every) {
+            telemetry.sinceLast = 0;
+
+            int32_t ticks1 = encoder1.encoder_getTicks();
+            float rpm1   = service1.encoder_getRPM();
+            float speed1 = service1.encoder_getSpeedCmS();
+            float dist1  = service1.encoder_getDistanceCm();
+            float rot1   = service1.encoder_getRotations();
 
-        int32_t ticks2 = encoder2.encoder_getTicks();
-        float rpm2   = service2.encoder_getRPM();
-        float speed2 = service2.encoder_getSpeedCmS();
-        float dist2  = service2.encoder_getDistanceCm();
-        float rot2   = service2.encoder_getRotations();
+            int32_t ticks2 = encoder2.encoder_getTicks();
+            float rpm2   = service2.encoder_getRPM();
+            float speed2 = service2.encoder_getSpeedCmS();
+            float dist2  = service2.encoder_getDistanceCm();
+            float rot2   = service2.encoder_getRotations();
 
-        printf("Encoder1 | Ticks: %d | RPM: %.2f | Speed: %.2f cm/s | Distance: %.2f cm | Rotations: %.2f\n",
-               ticks1, rpm1, speed1, dist1, rot1);
+            printf("Encoder1 | Ticks: %d | RPM: %.2f | Speed: %.2f cm/s | Distance: %.2f cm | Rotations: %.2f\n",
+                   ticks1, rpm1, speed1, dist1, rot1);
 
-        printf("Encoder2 | Ticks: %d | RPM: %.2f | Speed: %.2f cm/s | Distance: %.2f cm | Rotations: %.2f\n\n",
-               ticks2, rpm2, speed2, dist2, rot2);
+            printf("Encoder2 | Ticks: %d | RPM: %.2f | Speed: %.2f cm/s | Distance: %.2f cm | Rotations: %.2f\n\n",
+                   ticks2, rpm2, speed2, dist2, rot2);
+        }
+
+        /* ---------------------------
+           Wake-up latency and CPU load report (every 50 samples,
+           deferred while a trace dump is in progress)
+        --------------------------- */
+        if (++samplesSinceReport >= 50 && !dumping) {
+            SampleWakeStats wake = SampleEvent::event_getStats();
+            printf("Wake | Samples: %lu | Missed: %lu | Wakeups/sample: %.2f | Latency avg/min/max: %lu/%lu/%lu us\n\n",
+                   (unsigned long)wake.samples, (unsigned long)wake.missed,
+                   (float)wake.wakeups / wake.samples,
+                   (unsigned long)(wake.totalLatencyUs / wake.samples),
+                   (unsigned long)wake.minLatencyUs, (unsigned long)wake.maxLatencyUs);
+            SampleEvent::event_resetStats();
+            samplesSinceReport = 0;
+#if CPU_PROFILER_ENABLE
+            CpuProfiler::profiler_printSummary();
+            printf("\n");
+#endif
+        }
 
-        sleep_ms(100); // Loop delay
+        PROFILE_EXIT();
     }
 
     return 0;
@@ -20,10 +20,123 @@
  * Encoder Parameters
  ****************************************************************/
 
-// Encoder counts per revolution (CPR)
+// Encoder counts per revolution (CPR): decoded edges per wheel turn,
+// the default calibration and the basis of every edge rate below
 #define ENCODER_CPR 330
 
 // Radius of the wheel in centimeters
 #define WHEEL_RADIUS_CM 3.0f
 
+// Period of EncoderService updates (RPM, speed, distance) in milliseconds
+#define ENCODER_SAMPLE_PERIOD_MS 100
+
+// Maximum number of EncoderHAL instances
+#define ENCODER_MAX_INSTANCES 2
+
+/***************************************************************
+ * Glitch Filter and IRQ Storm Protection
+ * Description:
+ *     - An edge closer than the minimum interval to the last
+ *       accepted edge of the same encoder is physically impossible
+ *       and rejected as noise (the rated edge rate below is
+ *       ~866 us/edge).
+ *     - Once the pins stay quiet for that interval after a
+ *       rejection, the level they settled at is decoded, so
+ *       contact bounce right after a real edge keeps the edge.
+ *     - ENCODER_STORM_MAX_GLITCHES rejections within
+ *       ENCODER_STORM_WINDOW_US mask that encoder's IRQs for
+ *       ENCODER_STORM_MASK_US, protecting the CPU budget.
+ *     - Applies to the IRQ path only; polling and DMA sample at a
+ *       fixed rate and are unaffected by edge bursts.
+ ****************************************************************/
+#define ENCODER_MIN_EDGE_INTERVAL_US   15       // Default per encoder, 0 = off
+#define ENCODER_STORM_WINDOW_US        2000
+#define ENCODER_STORM_MAX_GLITCHES     16
+#define ENCODER_STORM_MASK_US          10000
+
+/***************************************************************
+ * Rated Edge Rate
+ * Description:
+ *     - Highest edge rate one encoder produces: ENCODER_CPR edges
+ *       per turn at the motor's 210 RPM is 1155 edges/s
+ *       (~866 us/edge).
+ *     - Polling and DMA sample rates and the hybrid thresholds
+ *       below are derived from it; an encoder calibrated to more
+ *       counts at run time needs ENCODER_CPR raised to match.
+ ****************************************************************/
+#define ENCODER_RATED_RPM              210
+#define ENCODER_EDGES_PER_REV          ENCODER_CPR
+#define ENCODER_RATED_EDGE_RATE        (ENCODER_EDGES_PER_REV * ENCODER_RATED_RPM / 60)
+
+/***************************************************************
+ * Hybrid IRQ / Polling Decoder
+ * Description:
+ *     - The summed edge rate of all encoders is measured every
+ *       ENCODER_HYBRID_WINDOW_MS.
+ *     - In POLLING mode GPIO IRQs are replaced by one batched
+ *       GPIO read of all encoders per hardware-alarm IRQ every
+ *       ENCODER_POLL_PERIOD_US: 25 % faster than the rated edge
+ *       rate of a single encoder, so no state is missed.
+ *     - A poll costs about ENCODER_POLL_COST_EDGES edge IRQs (one
+ *       hardware IRQ and one pin read each). Polling only pays
+ *       off above ENCODER_POLL_RATE x that cost in summed edges:
+ *       it is entered 25 % above the break-even point and left
+ *       below it. With two encoders at the rated speed (2310
+ *       edges/s) 1443 polls replace 2310 edge IRQs; a single
+ *       encoder never needs polling.
+ ****************************************************************/
+#define ENCODER_HYBRID_WINDOW_MS       10
+#define ENCODER_POLL_PERIOD_US         (1000000 / (ENCODER_RATED_EDGE_RATE * 5 / 4))
+#define ENCODER_POLL_RATE              (1000000 / ENCODER_POLL_PERIOD_US)
+#define ENCODER_POLL_COST_EDGES        1
+#define ENCODER_HYBRID_POLL_EXIT_EPS   (ENCODER_POLL_RATE * ENCODER_POLL_COST_EDGES)
+#define ENCODER_HYBRID_POLL_ENTER_EPS  (ENCODER_HYBRID_POLL_EXIT_EPS * 5 / 4)
+
+#if ENCODER_POLL_RATE <= ENCODER_RATED_EDGE_RATE
+#error "ENCODER_POLL_PERIOD_US too long for the rated edge rate"
+#endif
+
+/***************************************************************
+ * DMA Sampling Backend
+ * Description:
+ *     - All GPIO inputs are sampled ENCODER_DMA_SAMPLE_HZ times
+ *       per second into two buffers of ENCODER_DMA_BLOCK_SAMPLES.
+ *     - One decode pass runs per filled buffer:
+ *       100 kHz / 512 = ~195 passes per second.
+ *     - The sample rate must stay above the highest edge rate of
+ *       a single encoder.
+ *     - A buffer is a power of two bytes, at most 32 KB: the DMA
+ *       wraps its write address inside it (address ring), so a
+ *       late IRQ can never make it write past the buffer.
+ ****************************************************************/
+#define ENCODER_CAPTURE_DMA        0        // 1 = EncoderDMA instead of edge IRQs
+#define ENCODER_DMA_SAMPLE_HZ      100000
+#define ENCODER_DMA_BLOCK_SAMPLES  512
+#define ENCODER_DMA_BLOCK_BYTES    (ENCODER_DMA_BLOCK_SAMPLES * 4)
+
+#if ENCODER_DMA_SAMPLE_HZ <= ENCODER_RATED_EDGE_RATE
+#error "ENCODER_DMA_SAMPLE_HZ too low for the rated edge rate"
+#endif
+
+#if (ENCODER_DMA_BLOCK_BYTES & (ENCODER_DMA_BLOCK_BYTES - 1)) || ENCODER_DMA_BLOCK_BYTES > 32768
+#error "ENCODER_DMA_BLOCK_SAMPLES x 4 must be a power of two of at most 32768 bytes"
+#endif
+
+/***************************************************************
+ * Edge Trace Recorder
+ * Description:
+ *     - When enabled, every A/B change seen by the IRQ or polling
+ *       path is stored with its timestamp in a RAM ring buffer of
+ *       ENCODER_TRACE_CAPACITY records (4 bytes each) that can be
+ *       dumped over stdio and replayed on the host.
+ *     - A dump prints ENCODER_TRACE_DUMP_LINES lines of 8 records
+ *       (~580 bytes) per control tick: a full ring takes 32 ticks
+ *       instead of blocking one tick for ~18 KB of output.
+ ****************************************************************/
+#ifndef ENCODER_TRACE_ENABLE
+#define ENCODER_TRACE_ENABLE      0
+#endif
+#define ENCODER_TRACE_CAPACITY    2048
+#define ENCODER_TRACE_DUMP_LINES  8
+
 #endif // ENCODER_CONFIG_HPP
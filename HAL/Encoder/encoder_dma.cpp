@@ -0,0 +1,162 @@
+#include "Encoder/encoder_dma.hpp"
+#include "Encoder/quadrature_table.hpp"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "Profiler/cpu_profiler.hpp"
+
+/***************************************************************
+ * PIO Sampling Program
+ * Description:
+ *     - "in pins, 32" with in_base = 0 and autopush at 32 bits:
+ *       one full GPIO snapshot (bit n = GPIO n, the same layout
+ *       as gpio_get_all) per state machine clock.
+ *     - The GPIO register lives in SIO, which the DMA cannot
+ *       read, so PIO does the sampling and DMA drains its FIFO.
+ ****************************************************************/
+static const uint16_t samplerInstructions[] = {
+    0x4000,     // in pins, 32
+};
+
+static const struct pio_program samplerProgram = {
+    samplerInstructions,
+    1,
+    -1,
+};
+
+// Write ring size: log2 of the buffer size in bytes
+static constexpr uint ringBits(uint32_t bytes) {
+    return bytes > 1 ? 1 + ringBits(bytes >> 1) : 0;
+}
+
+/***************************************************************
+ * Static Members Initialization
+ ****************************************************************/
+EncoderDMA* EncoderDMA::instance = nullptr;
+
+/***************************************************************
+ * Constructor
+ ****************************************************************/
+EncoderDMA::EncoderDMA()
+    : _pio(pio0), _sm(0), _chan{-1, -1}, _nextHalf(0),
+      _passes(0), _overruns(0) {}
+
+/***************************************************************
+ * Method: encoder_dmaStart
+ ****************************************************************/
+void EncoderDMA::encoder_dmaStart(uint32_t sampleRateHz) {
+    instance = this;
+
+    // Batch decoder channels mirror the registered encoders
+    uint32_t now = gpio_get_all();
+    for (int i = 0; i < EncoderHAL::instanceCount; i++) {
+        EncoderHAL* hal = EncoderHAL::instances[i];
+        _decoder.addChannel(hal->_pinA, hal->_pinB, now);
+        hal->_lastState = quadratureState(now, hal->_pinA, hal->_pinB);
+    }
+
+    // -------- PIO sampler --------
+    uint offset = pio_add_program(_pio, &samplerProgram);
+    _sm = pio_claim_unused_sm(_pio, true);
+
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset, offset);
+    sm_config_set_in_pins(&c, 0);
+    sm_config_set_in_shift(&c, true, true, 32);
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_RX);
+    sm_config_set_clkdiv(&c, (float)clock_get_hz(clk_sys) / sampleRateHz);
+    pio_sm_init(_pio, _sm, offset, &c);
+
+    // -------- Ping-pong DMA --------
+    _chan[0] = dma_claim_unused_channel(true);
+    _chan[1] = dma_claim_unused_channel(true);
+
+    for (int half = 0; half < 2; half++) {
+        dma_channel_config dc = dma_channel_get_default_config(_chan[half]);
+        channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+        channel_config_set_read_increment(&dc, false);
+        channel_config_set_write_increment(&dc, true);
+        channel_config_set_dreq(&dc, pio_get_dreq(_pio, _sm, false));
+        channel_config_set_chain_to(&dc, _chan[half ^ 1]);
+        // Write address wraps back to the buffer start at the end of
+        // each block: the chained re-trigger refills it in place
+        channel_config_set_ring(&dc, true, ringBits(ENCODER_DMA_BLOCK_BYTES));
+
+        dma_channel_configure(_chan[half], &dc, _buffer[half], &_pio->rxf[_sm],
+                              ENCODER_DMA_BLOCK_SAMPLES, false);
+        dma_channel_set_irq0_enabled(_chan[half], true);
+    }
+
+    irq_set_exclusive_handler(DMA_IRQ_0, &EncoderDMA::dmaIrqHandler);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    dma_channel_start(_chan[0]);
+    pio_sm_set_enabled(_pio, _sm, true);
+}
+
+/***************************************************************
+ * Static ISR: dmaIrqHandler
+ ****************************************************************/
+void EncoderDMA::dmaIrqHandler() {
+    PROFILE_ZONE(ENCODER_ISR);
+    EncoderDMA* self = instance;
+
+    bool first = dma_channel_get_irq0_status(self->_chan[0]);
+    bool second = dma_channel_get_irq0_status(self->_chan[1]);
+    if (first && second) {
+        // A block or more late: the busy channel is refilling its
+        // half. Drop everything before the last complete half.
+        int done = dma_channel_is_busy(self->_chan[0]) ? 1 : 0;
+        dma_channel_acknowledge_irq0(self->_chan[done ^ 1]);
+        self->_nextHalf = done;
+        self->_decoder.resync(self->_buffer[done][0]);
+        self->_overruns++;
+    }
+
+    // Decode in completion order, starting with the expected half
+    for (int n = 0; n < 2; n++) {
+        int half = self->_nextHalf;
+        if (!dma_channel_get_irq0_status(self->_chan[half])) {
+            break;
+        }
+
+        dma_channel_acknowledge_irq0(self->_chan[half]);
+        self->processBuffer(half);
+        self->_nextHalf = half ^ 1;
+    }
+}
+
+/***************************************************************
+ * Method: processBuffer
+ ****************************************************************/
+void EncoderDMA::processBuffer(int half) {
+    _decoder.decode(_buffer[half], ENCODER_DMA_BLOCK_SAMPLES);
+
+    for (int i = 0; i < _decoder.channelCount(); i++) {
+        QuadratureChannel& ch = _decoder.channel(i);
+        EncoderHAL* hal = EncoderHAL::instances[i];
+
+        if (ch.ticks > 0) {
+            hal->_direction = EncoderDirection::FORWARD;
+        } else if (ch.ticks < 0) {
+            hal->_direction = EncoderDirection::BACKWARD;
+        }
+        hal->_ticks += ch.ticks;
+        hal->_edges += ch.edges;
+        hal->_errors += ch.errors;
+        hal->_lastState = ch.lastState;
+
+        ch.ticks = 0;
+        ch.edges = 0;
+        ch.errors = 0;
+    }
+
+    _passes++;
+}
+
+/***************************************************************
+ * Getter Methods
+ ****************************************************************/
+uint32_t EncoderDMA::encoder_dmaGetPasses() const { return _passes; }
+
+uint32_t EncoderDMA::encoder_dmaGetOverruns() const { return _overruns; }
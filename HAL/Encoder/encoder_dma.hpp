@@ -0,0 +1,92 @@
+#ifndef ENCODER_DMA_HPP
+#define ENCODER_DMA_HPP
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "Encoder/encoder_hal.hpp"
+#include "Encoder/quadrature_batch.hpp"
+
+/***************************************************************
+ * Class: EncoderDMA
+ * Layer: HAL (Hardware Abstraction Layer)
+ * Description:
+ *     - Zero-ISR-per-edge capture backend for all EncoderHAL
+ *       instances initialized with EncoderMode::DMA.
+ *     - A PIO state machine samples the GPIO input register at a
+ *       fixed rate; two chained DMA channels store the samples
+ *       in a ping-pong double buffer.
+ *     - Each completed buffer raises one DMA IRQ, which decodes
+ *       all encoders in one QuadratureBatchDecoder pass and adds
+ *       the results to the EncoderHAL counters.
+ *     - Each channel's write address wraps inside its own buffer
+ *       (DMA address ring), so the channels re-arm themselves and
+ *       stay in bounds however late the IRQ runs.
+ ****************************************************************/
+class EncoderDMA {
+public:
+    /***********************************************************
+     * Constructor: EncoderDMA
+     * Description:
+     *     - Initializes internal variables only.
+     ***********************************************************/
+    EncoderDMA();
+
+    /***********************************************************
+     * Method: encoder_dmaStart
+     * Parameters:
+     *     - sampleRateHz: GPIO sample rate
+     * Description:
+     *     - Claims a PIO state machine and two DMA channels and
+     *       starts sampling.
+     *     - Call after encoder_init(EncoderMode::DMA) of every
+     *       encoder. Only one EncoderDMA may run.
+     ***********************************************************/
+    void encoder_dmaStart(uint32_t sampleRateHz = ENCODER_DMA_SAMPLE_HZ);
+
+    /***********************************************************
+     * Method: encoder_dmaGetPasses
+     * Description:
+     *     - Returns the number of buffers decoded.
+     ***********************************************************/
+    uint32_t encoder_dmaGetPasses() const;
+
+    /***********************************************************
+     * Method: encoder_dmaGetOverruns
+     * Description:
+     *     - Returns how often both buffers were complete when the
+     *       IRQ ran, i.e. decoding fell a whole buffer behind.
+     *       Samples up to the last complete buffer are dropped
+     *       then, and decoding resumes from that buffer.
+     ***********************************************************/
+    uint32_t encoder_dmaGetOverruns() const;
+
+private:
+    /***********************************************************
+     * Static ISR: dmaIrqHandler
+     * Description:
+     *     - Decodes each completed buffer in order.
+     ***********************************************************/
+    static void dmaIrqHandler();
+
+    /***********************************************************
+     * Method: processBuffer
+     * Description:
+     *     - Batch decode of one buffer, then publishes per-encoder
+     *       results to the EncoderHAL instances.
+     ***********************************************************/
+    void processBuffer(int half);
+
+    alignas(ENCODER_DMA_BLOCK_BYTES)
+    uint32_t _buffer[2][ENCODER_DMA_BLOCK_SAMPLES];  // Ping-pong sample buffers, ring aligned
+    QuadratureBatchDecoder _decoder;        // Decode state of all encoders
+    PIO _pio;                               // PIO block used for sampling
+    uint _sm;                               // Sampling state machine
+    int _chan[2];                           // DMA channel per buffer half
+    int _nextHalf;                          // Buffer expected to complete next
+    volatile uint32_t _passes;              // Buffers decoded
+    volatile uint32_t _overruns;            // Decode fell behind
+
+    static EncoderDMA* instance;            // Active backend for the IRQ
+};
+
+#endif // ENCODER_DMA_HPP
@@ -1,18 +1,31 @@
 #include "Encoder/encoder_hal.hpp"
+#include "Encoder/quadrature_table.hpp"
+#include "Encoder/encoder_trace.hpp"
+#include "Profiler/cpu_profiler.hpp"
+#include "hardware/sync.h"
 
 /***************************************************************
  * Static Members Initialization
  ****************************************************************/
-EncoderHAL* EncoderHAL::instances[2] = {nullptr, nullptr};
+EncoderHAL* EncoderHAL::instances[ENCODER_MAX_INSTANCES] = {nullptr};
 int EncoderHAL::instanceCount = 0;
 
+volatile EncoderMode EncoderHAL::mode = EncoderMode::INTERRUPT;
+volatile uint32_t EncoderHAL::edgeRate = 0;
+struct repeating_timer EncoderHAL::rateTimer;
+int EncoderHAL::pollAlarm = -1;
+absolute_time_t EncoderHAL::pollTarget;
+
 /***************************************************************
  * Constructor
  ****************************************************************/
 EncoderHAL::EncoderHAL(uint pinA, uint pinB)
-    : _pinA(pinA), _pinB(pinB),
+    : _pinA(pinA), _pinB(pinB), _index(static_cast<uint8_t>(instanceCount)),
       _ticks(0), _direction(EncoderDirection::UNKNOWN),
-      _lastA(false), _lastB(false)
+      _lastState(0), _edges(0), _errors(0), _windowEdges(0),
+      _minEdgeUs(ENCODER_MIN_EDGE_INTERVAL_US), _lastEdgeUs(0),
+      _prevState(0), _lastStep(0), _lastRejectUs(0), _settlePending(false), _glitches(0),
+      _stormStartUs(0), _stormGlitches(0), _storms(0), _masked(false), _alarmFailures(0)
 {
     // Register this encoder instance for ISR handling
     instances[instanceCount++] = this;
@@ -21,7 +34,7 @@ EncoderHAL::EncoderHAL(uint pinA, uint pinB)
 /***************************************************************
  * Method: encoder_init
  ****************************************************************/
-void EncoderHAL::encoder_init() {
+void EncoderHAL::encoder_init(EncoderMode captureMode) {
     gpio_init(_pinA);
     gpio_init(_pinB);
 
@@ -31,8 +44,17 @@ void EncoderHAL::encoder_init() {
     gpio_pull_up(_pinA);
     gpio_pull_up(_pinB);
 
-    _lastA = gpio_get(_pinA);
-    _lastB = gpio_get(_pinB);
+    _lastState = quadratureState(gpio_get_all(), _pinA, _pinB);
+    _lastEdgeUs = time_us_32() - _minEdgeUs;    // First edge is always accepted
+
+#if ENCODER_TRACE_ENABLE
+    EncoderTrace::trace_begin(_index, _lastState, time_us_32());
+#endif
+
+    if (captureMode == EncoderMode::DMA) {
+        mode = EncoderMode::DMA;
+        return;
+    }
 
     // Enable interrupts on both edges
     gpio_set_irq_enabled_with_callback(
@@ -52,11 +74,14 @@ void EncoderHAL::encoder_init() {
 /***************************************************************
  * Static ISR Callback
  ****************************************************************/
-void EncoderHAL::encoder_gpioCallback(uint gpio, uint32_t events) {
+void EncoderHAL::encoder_gpioCallback(uint gpio, uint32_t /*events*/) {
+    uint32_t now = time_us_32();
+    PROFILE_ZONE(ENCODER_ISR);
+
     // Dispatch interrupt to the correct encoder instance
     for (int i = 0; i < instanceCount; i++) {
         if (gpio == instances[i]->_pinA || gpio == instances[i]->_pinB) {
-            instances[i]->handleEncoder();
+            instances[i]->handleEncoder(now);
         }
     }
 }
@@ -64,22 +89,141 @@ void EncoderHAL::encoder_gpioCallback(uint gpio, uint32_t events) {
 /***************************************************************
  * Method: handleEncoder
  ****************************************************************/
-void EncoderHAL::handleEncoder() {
-    bool a = gpio_get(_pinA);
-    bool b = gpio_get(_pinB);
+void EncoderHAL::handleEncoder(uint32_t nowUs) {
+    uint8_t state = quadratureState(gpio_get_all(), _pinA, _pinB);
+
+#if ENCODER_TRACE_ENABLE
+    EncoderTrace::trace_record(_index, state, nowUs);   // Raw, before filtering
+#endif
+
+    if (state == _lastState) {
+        return;     // Pulse already over, nothing to decode
+    }
+
+    if (_minEdgeUs != 0 && (nowUs - _lastEdgeUs) < _minEdgeUs) {
+        rejectGlitch(state, nowUs);
+        return;
+    }
+
+    _prevState = _lastState;
+    _lastStep = decode(state);
+    _lastEdgeUs = nowUs;
+}
+
+/***************************************************************
+ * Method: rejectGlitch
+ ****************************************************************/
+void EncoderHAL::rejectGlitch(uint8_t state, uint32_t nowUs) {
+    _glitches++;
+
+    if (state == _prevState && (_lastStep == 1 || _lastStep == -1)) {
+        // Spike: the previous edge was its leading half
+        _ticks -= _lastStep;
+        _edges--;
+        _lastStep = 0;
+        _lastState = state;
+    }
 
-    if (a != _lastA || b != _lastB) {
-        if (_lastA == _lastB) {
-            if (a != b) { _ticks++; _direction = EncoderDirection::FORWARD; }
-            else        { _ticks--; _direction = EncoderDirection::BACKWARD; }
+    // The level is decoded once the pins stay quiet for the interval;
+    // without an alarm slot the next rejected edge tries again
+    _lastRejectUs = nowUs;
+    if (!_settlePending) {
+        if (add_alarm_in_us(_minEdgeUs, &EncoderHAL::settleCallback, this, true) > 0) {
+            _settlePending = true;
         } else {
-            if (a == b) { _ticks++; _direction = EncoderDirection::FORWARD; }
-            else        { _ticks--; _direction = EncoderDirection::BACKWARD; }
+            _alarmFailures++;
         }
     }
 
-    _lastA = a;
-    _lastB = b;
+    if (nowUs - _stormStartUs > ENCODER_STORM_WINDOW_US) {
+        _stormStartUs = nowUs;
+        _stormGlitches = 0;
+    }
+
+    // Masked only with the alarm to unmask it scheduled
+    if (++_stormGlitches >= ENCODER_STORM_MAX_GLITCHES && !_masked) {
+        if (add_alarm_in_us(ENCODER_STORM_MASK_US, &EncoderHAL::unmaskCallback, this, true) > 0) {
+            gpio_set_irq_enabled(_pinA, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, false);
+            gpio_set_irq_enabled(_pinB, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, false);
+            _masked = true;
+            _storms++;
+        } else {
+            _alarmFailures++;
+        }
+    }
+}
+
+/***************************************************************
+ * Static Alarm Callback: unmaskCallback
+ ****************************************************************/
+int64_t EncoderHAL::unmaskCallback(alarm_id_t /*id*/, void* user_data) {
+    EncoderHAL* self = static_cast<EncoderHAL*>(user_data);
+    PROFILE_ZONE(TIMER_CALLBACK);
+
+    uint32_t irq = save_and_disable_interrupts();
+    self->_masked = false;
+    self->_stormGlitches = 0;
+    if (mode == EncoderMode::INTERRUPT) {
+        gpio_set_irq_enabled(self->_pinA, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true);
+        gpio_set_irq_enabled(self->_pinB, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true);
+        self->decode(quadratureState(gpio_get_all(), self->_pinA, self->_pinB));
+        self->_lastStep = 0;
+        self->_lastEdgeUs = time_us_32() - self->_minEdgeUs;
+    }
+    restore_interrupts(irq);
+
+    return 0;   // One-shot
+}
+
+/***************************************************************
+ * Static Alarm Callback: settleCallback
+ ****************************************************************/
+int64_t EncoderHAL::settleCallback(alarm_id_t /*id*/, void* user_data) {
+    EncoderHAL* self = static_cast<EncoderHAL*>(user_data);
+    PROFILE_ZONE(TIMER_CALLBACK);
+    int64_t again = 0;
+
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t now = time_us_32();
+    uint32_t quiet = now - self->_lastRejectUs;
+    if (mode == EncoderMode::INTERRUPT && !self->_masked) {
+        if (quiet < self->_minEdgeUs) {
+            again = self->_minEdgeUs - quiet;   // Still bouncing
+        } else {
+            uint8_t state = quadratureState(gpio_get_all(), self->_pinA, self->_pinB);
+            if (state != self->_lastState) {
+                self->_prevState = self->_lastState;
+                self->_lastStep = self->decode(state);
+                self->_lastEdgeUs = now;
+            }
+        }
+    }
+    self->_settlePending = (again != 0);
+    restore_interrupts(irq);
+
+    return again;
+}
+
+/***************************************************************
+ * Method: decode
+ ****************************************************************/
+inline int8_t EncoderHAL::decode(uint8_t state) {
+    int8_t step = quadratureTable[(_lastState << 2) | state];
+
+    if (step == 1) {
+        _ticks++;
+        _edges++;
+        _direction = EncoderDirection::FORWARD;
+    } else if (step == -1) {
+        _ticks--;
+        _edges++;
+        _direction = EncoderDirection::BACKWARD;
+    } else if (step == QUADRATURE_INVALID) {
+        _errors++;
+    }
+
+    _lastState = state;
+    return step;
 }
 
 /***************************************************************
@@ -95,3 +239,147 @@ void EncoderHAL::encoder_clear() {
 EncoderDirection EncoderHAL::encoder_getDirection() const {
     return _direction;
 }
+
+uint32_t EncoderHAL::encoder_getEdgeCount() const { return _edges; }
+
+uint32_t EncoderHAL::encoder_getErrorCount() const { return _errors; }
+
+void EncoderHAL::encoder_setGlitchFilter(uint32_t minEdgeIntervalUs) {
+    _minEdgeUs = minEdgeIntervalUs;
+}
+
+uint32_t EncoderHAL::encoder_getGlitchCount() const { return _glitches; }
+
+uint32_t EncoderHAL::encoder_getStormCount() const { return _storms; }
+
+uint32_t EncoderHAL::encoder_getAlarmFailureCount() const { return _alarmFailures; }
+
+bool EncoderHAL::encoder_isMasked() const { return _masked; }
+
+EncoderMode EncoderHAL::encoder_getMode() { return mode; }
+
+uint32_t EncoderHAL::encoder_getEdgeRate() { return edgeRate; }
+
+/***************************************************************
+ * Static Method: encoder_startHybrid
+ ****************************************************************/
+void EncoderHAL::encoder_startHybrid() {
+    for (int i = 0; i < instanceCount; i++) {
+        instances[i]->_windowEdges = instances[i]->_edges;
+    }
+
+    // A dedicated hardware alarm: one plain IRQ per poll
+    if (pollAlarm < 0) {
+        pollAlarm = hardware_alarm_claim_unused(true);
+        hardware_alarm_set_callback(pollAlarm, &EncoderHAL::pollAlarmCallback);
+    }
+
+    // Negative delay: fixed period between callback starts
+    add_repeating_timer_ms(-ENCODER_HYBRID_WINDOW_MS, &EncoderHAL::rateCallback, nullptr, &rateTimer);
+}
+
+/***************************************************************
+ * Static Timer Callback: rateCallback
+ ****************************************************************/
+bool EncoderHAL::rateCallback(struct repeating_timer* /*t*/) {
+    PROFILE_ZONE(TIMER_CALLBACK);
+    uint32_t edges = 0;
+    for (int i = 0; i < instanceCount; i++) {
+        uint32_t now = instances[i]->_edges;
+        edges += now - instances[i]->_windowEdges;
+        instances[i]->_windowEdges = now;
+    }
+    edgeRate = edges * (1000u / ENCODER_HYBRID_WINDOW_MS);
+
+    // Hysteresis between the two thresholds avoids mode chatter
+    if (mode == EncoderMode::INTERRUPT && edgeRate > ENCODER_HYBRID_POLL_ENTER_EPS) {
+        enterPolling();
+    } else if (mode == EncoderMode::POLLING && edgeRate < ENCODER_HYBRID_POLL_EXIT_EPS) {
+        exitPolling();
+    }
+    return true;
+}
+
+/***************************************************************
+ * Static Alarm Callback: pollAlarmCallback
+ * Description:
+ *     - Next target from the previous one; targets already in
+ *       the past are skipped rather than fired back to back.
+ ****************************************************************/
+void EncoderHAL::pollAlarmCallback(uint alarm_num) {
+    PROFILE_ZONE(ENCODER_ISR);
+    if (mode != EncoderMode::POLLING) {
+        return;
+    }
+    pollTarget = delayed_by_us(pollTarget, ENCODER_POLL_PERIOD_US);
+    while (hardware_alarm_set_target(alarm_num, pollTarget)) {
+        pollTarget = delayed_by_us(pollTarget, ENCODER_POLL_PERIOD_US);
+    }
+    pollAll();
+}
+
+/***************************************************************
+ * Static Method: pollAll
+ ****************************************************************/
+void EncoderHAL::pollAll() {
+    // One register read captures every encoder at the same instant
+    uint32_t all = gpio_get_all();
+#if ENCODER_TRACE_ENABLE
+    uint32_t now = time_us_32();
+#endif
+    for (int i = 0; i < instanceCount; i++) {
+        uint8_t state = quadratureState(all, instances[i]->_pinA, instances[i]->_pinB);
+#if ENCODER_TRACE_ENABLE
+        EncoderTrace::trace_record(instances[i]->_index, state, now);
+#endif
+        instances[i]->decode(state);
+    }
+}
+
+/***************************************************************
+ * Static Method: setEdgeIrqs
+ ****************************************************************/
+void EncoderHAL::setEdgeIrqs(bool enabled) {
+    for (int i = 0; i < instanceCount; i++) {
+        if (enabled && instances[i]->_masked) {
+            continue;   // unmaskCallback re-enables it
+        }
+        gpio_set_irq_enabled(instances[i]->_pinA, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, enabled);
+        gpio_set_irq_enabled(instances[i]->_pinB, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, enabled);
+    }
+}
+
+/***************************************************************
+ * Static Method: enterPolling
+ * Description:
+ *     - _lastState is kept, so an edge between masking the IRQs
+ *       and the first poll is still decoded by that poll.
+ ****************************************************************/
+void EncoderHAL::enterPolling() {
+    setEdgeIrqs(false);
+    mode = EncoderMode::POLLING;
+    pollAll();
+    pollTarget = delayed_by_us(get_absolute_time(), ENCODER_POLL_PERIOD_US);
+    hardware_alarm_set_target(pollAlarm, pollTarget);
+}
+
+/***************************************************************
+ * Static Method: exitPolling
+ * Description:
+ *     - IRQs are re-armed (pending edges acknowledged by the SDK)
+ *       and the pins decoded once with interrupts off, so an edge
+ *       between the last poll and re-arming is not lost.
+ ****************************************************************/
+void EncoderHAL::exitPolling() {
+    hardware_alarm_cancel(pollAlarm);
+
+    uint32_t irq = save_and_disable_interrupts();
+    setEdgeIrqs(true);
+    mode = EncoderMode::INTERRUPT;
+    pollAll();
+    for (int i = 0; i < instanceCount; i++) {
+        instances[i]->_lastStep = 0;    // Polled edges cannot be undone as glitches
+        instances[i]->_lastEdgeUs = time_us_32() - instances[i]->_minEdgeUs;
+    }
+    restore_interrupts(irq);
+}
@@ -2,6 +2,7 @@
 #define ENCODER_HAL_HPP
 
 #include "pico/stdlib.h"
+#include "hardware/timer.h"
 #include "Encoder/encoder_config.hpp"
 
 /***************************************************************
@@ -11,6 +12,16 @@
  ****************************************************************/
 enum class EncoderDirection { UNKNOWN, FORWARD, BACKWARD };
 
+/***************************************************************
+ * Enum: EncoderMode
+ * Description:
+ *     - How edges of all encoders are currently captured.
+ *     - INTERRUPT: one GPIO IRQ per edge.
+ *     - POLLING: fixed-rate timer reads all pins at once.
+ *     - DMA: pins sampled by PIO + DMA, decoded by EncoderDMA.
+ ****************************************************************/
+enum class EncoderMode { INTERRUPT, POLLING, DMA };
+
 /***************************************************************
  * Class: EncoderHAL
  * Layer: HAL (Hardware Abstraction Layer)
@@ -18,6 +29,8 @@ enum class EncoderDirection { UNKNOWN, FORWARD, BACKWARD };
  *     - Low-level interface for a quadrature encoder.
  *     - Supports multiple encoder instances.
  *     - Handles GPIO initialization, interrupts, and tick counting.
+ *     - Optionally switches all encoders between per-edge IRQs and
+ *       batched timer polling depending on the edge rate.
  ****************************************************************/
 class EncoderHAL {
 public:
@@ -34,10 +47,13 @@ public:
 
     /***********************************************************
      * Method: encoder_init
+     * Parameters:
+     *     - captureMode: INTERRUPT (default) enables edge IRQs;
+     *       DMA only configures the pins for EncoderDMA.
      * Description:
      *     - Initializes GPIO pins and enables interrupts.
      ***********************************************************/
-    void encoder_init();
+    void encoder_init(EncoderMode captureMode = EncoderMode::INTERRUPT);
 
     /***********************************************************
      * Method: encoder_getTicks
@@ -60,7 +76,87 @@ public:
      ***********************************************************/
     EncoderDirection encoder_getDirection() const;
 
+    /***********************************************************
+     * Method: encoder_getEdgeCount
+     * Description:
+     *     - Returns the number of valid edges decoded since init.
+     *     - Wraps around; use differences between readings.
+     ***********************************************************/
+    uint32_t encoder_getEdgeCount() const;
+
+    /***********************************************************
+     * Method: encoder_getErrorCount
+     * Description:
+     *     - Returns the number of invalid transitions (both
+     *       channels changed at once, an edge was missed).
+     ***********************************************************/
+    uint32_t encoder_getErrorCount() const;
+
+    /***********************************************************
+     * Method: encoder_setGlitchFilter
+     * Parameters:
+     *     - minEdgeIntervalUs: shortest accepted time between two
+     *       edges of this encoder, 0 disables the filter
+     ***********************************************************/
+    void encoder_setGlitchFilter(uint32_t minEdgeIntervalUs);
+
+    /***********************************************************
+     * Method: encoder_getGlitchCount
+     * Description:
+     *     - Returns the number of edges rejected by the filter.
+     ***********************************************************/
+    uint32_t encoder_getGlitchCount() const;
+
+    /***********************************************************
+     * Method: encoder_getStormCount
+     * Description:
+     *     - Returns how often this encoder's IRQs were masked
+     *       because of a glitch storm.
+     ***********************************************************/
+    uint32_t encoder_getStormCount() const;
+
+    /***********************************************************
+     * Method: encoder_getAlarmFailureCount
+     * Description:
+     *     - Returns how often a settle or unmask alarm could not
+     *       be scheduled (no free alarm slot).
+     ***********************************************************/
+    uint32_t encoder_getAlarmFailureCount() const;
+
+    /***********************************************************
+     * Method: encoder_isMasked
+     * Description:
+     *     - True while IRQs are masked after a glitch storm.
+     ***********************************************************/
+    bool encoder_isMasked() const;
+
+    /***********************************************************
+     * Static Method: encoder_startHybrid
+     * Description:
+     *     - Starts the edge-rate monitor that switches all
+     *       encoders between INTERRUPT and POLLING mode.
+     *     - Call after encoder_init() of every instance.
+     ***********************************************************/
+    static void encoder_startHybrid();
+
+    /***********************************************************
+     * Static Method: encoder_getMode
+     * Description:
+     *     - Returns the current capture mode.
+     ***********************************************************/
+    static EncoderMode encoder_getMode();
+
+    /***********************************************************
+     * Static Method: encoder_getEdgeRate
+     * Description:
+     *     - Returns the summed edge rate of all encoders
+     *       (edges/s) measured in the last monitor window.
+     ***********************************************************/
+    static uint32_t encoder_getEdgeRate();
+
 private:
+    friend class EncoderDMA;                // Drains batch decode results
+
     /***********************************************************
      * Static ISR Callback: encoder_gpioCallback
      * Description:
@@ -71,20 +167,105 @@ private:
 
     /***********************************************************
      * Method: handleEncoder
+     * Parameters:
+     *     - nowUs: edge timestamp taken on ISR entry
      * Description:
      *     - Processes quadrature logic.
      *     - Updates tick count and direction.
+     *     - Rejects edges faster than the glitch filter allows.
      ***********************************************************/
-    void handleEncoder();
+    void handleEncoder(uint32_t nowUs);
+
+    /***********************************************************
+     * Method: rejectGlitch
+     * Description:
+     *     - Counts a rejected edge. A glitch that returns the pins
+     *       to the state before the last accepted edge cancels that
+     *       edge's step; otherwise the last accepted state is kept,
+     *       so noise can never add a step.
+     *     - Arms settleCallback, which decodes the level the pins
+     *       settle at, so a real edge followed by bounce is kept.
+     *     - Masks the encoder when glitches form a storm.
+     ***********************************************************/
+    void rejectGlitch(uint8_t state, uint32_t nowUs);
+
+    /***********************************************************
+     * Static Alarm Callback: unmaskCallback
+     * Description:
+     *     - Re-enables a storm-masked encoder and decodes any
+     *       movement made while masked.
+     ***********************************************************/
+    static int64_t unmaskCallback(alarm_id_t id, void* user_data);
+
+    /***********************************************************
+     * Static Alarm Callback: settleCallback
+     * Description:
+     *     - Runs once the pins have not changed for the filter
+     *       interval after a rejected edge, and decodes their
+     *       level if it differs from the last accepted state.
+     ***********************************************************/
+    static int64_t settleCallback(alarm_id_t id, void* user_data);
+
+    /***********************************************************
+     * Method: decode
+     * Parameters:
+     *     - state: new 2-bit state (A << 1) | B
+     * Description:
+     *     - Table-driven quadrature step shared by IRQ and
+     *       polling paths.
+     *     - Returns the table entry for the transition.
+     ***********************************************************/
+    inline int8_t decode(uint8_t state);
+
+    /***********************************************************
+     * Static Timer Callbacks
+     * Description:
+     *     - pollAlarmCallback: hardware alarm of POLLING mode,
+     *       re-armed every ENCODER_POLL_PERIOD_US.
+     *     - pollAll: batched GPIO read and decode of all encoders.
+     *     - rateCallback: edge-rate monitor with hysteresis.
+     ***********************************************************/
+    static void pollAlarmCallback(uint alarm_num);
+    static void pollAll();
+    static bool rateCallback(struct repeating_timer* t);
+
+    static void enterPolling();
+    static void exitPolling();
+    static void setEdgeIrqs(bool enabled);
 
     uint _pinA, _pinB;                      // Encoder GPIO pins
+    uint8_t _index;                         // Position in instance registry
     volatile int32_t _ticks;                // Tick counter
     volatile EncoderDirection _direction;   // Rotation direction
-    volatile bool _lastA, _lastB;           // Previous pin states
+    volatile uint8_t _lastState;            // Previous pin state (A << 1) | B
+    volatile uint32_t _edges;               // Valid edges decoded
+    volatile uint32_t _errors;              // Invalid transitions seen
+    uint32_t _windowEdges;                  // _edges at start of rate window
+
+    // -------- Glitch filter --------
+    uint32_t _minEdgeUs;                    // Minimum accepted edge interval
+    uint32_t _lastEdgeUs;                   // Time of last accepted edge
+    uint8_t _prevState;                     // State before last accepted edge
+    int8_t _lastStep;                       // Step of last accepted edge
+    uint32_t _lastRejectUs;                 // Time of last rejected edge
+    volatile bool _settlePending;           // settleCallback armed
+    volatile uint32_t _glitches;            // Rejected edges
+    uint32_t _stormStartUs;                 // Start of storm detection window
+    uint32_t _stormGlitches;                // Rejections in current window
+    volatile uint32_t _storms;              // Times masked
+    volatile bool _masked;                  // IRQs masked by storm protection
+    volatile uint32_t _alarmFailures;       // Settle/unmask alarms not scheduled
 
     // -------- Static instance registry --------
-    static EncoderHAL* instances[2];        // List of encoder instances
+    static EncoderHAL* instances[ENCODER_MAX_INSTANCES];  // List of encoder instances
     static int instanceCount;               // Number of registered encoders
+
+    // -------- Hybrid decoder state --------
+    static volatile EncoderMode mode;       // Current capture mode
+    static volatile uint32_t edgeRate;      // Edges/s in last window
+    static struct repeating_timer rateTimer;  // Edge-rate monitor
+    static int pollAlarm;                   // Hardware alarm of the poller, -1 before start
+    static absolute_time_t pollTarget;      // Next poll
 };
 
 #endif // ENCODER_HAL_HPP
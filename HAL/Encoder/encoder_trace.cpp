@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "Encoder/encoder_trace.hpp"
+#include "hardware/sync.h"
+
+/***************************************************************
+ * Static Members Initialization
+ ****************************************************************/
+uint32_t EncoderTrace::buffer[ENCODER_TRACE_CAPACITY];
+uint32_t EncoderTrace::head = 0;
+uint32_t EncoderTrace::count = 0;
+uint32_t EncoderTrace::startUs = 0;
+uint32_t EncoderTrace::lastUs = 0;
+uint8_t EncoderTrace::encoders = 0;
+uint8_t EncoderTrace::startState[ENCODER_MAX_INSTANCES];
+uint8_t EncoderTrace::lastState[ENCODER_MAX_INSTANCES];
+uint8_t EncoderTrace::liveState[ENCODER_MAX_INSTANCES];
+volatile bool EncoderTrace::frozen = false;
+bool EncoderTrace::dumping = false;
+bool EncoderTrace::dumpWasFrozen = false;
+uint32_t EncoderTrace::dumpIndex = 0;
+uint32_t EncoderTrace::dumpPrinted = 0;
+
+/***************************************************************
+ * Static Method: trace_begin
+ ****************************************************************/
+void EncoderTrace::trace_begin(uint8_t encoder, uint8_t state, uint32_t nowUs) {
+    uint32_t irq = save_and_disable_interrupts();
+    if (count == 0) {
+        startUs = nowUs;
+        lastUs = nowUs;
+    }
+    startState[encoder] = state;
+    lastState[encoder] = state;
+    liveState[encoder] = state;
+    if (encoder >= encoders) {
+        encoders = encoder + 1;
+    }
+    restore_interrupts(irq);
+}
+
+/***************************************************************
+ * Static Method: push
+ * Description:
+ *     - Stores one record, dropping the oldest when full and
+ *       folding it into the start time and states.
+ ****************************************************************/
+void EncoderTrace::push(uint32_t word) {
+    if (count == ENCODER_TRACE_CAPACITY) {
+        uint32_t oldest = buffer[head];
+        startUs += traceDelta(oldest);
+        if (traceEncoder(oldest) != TRACE_INDEX_GAP) {
+            startState[traceEncoder(oldest)] = traceState(oldest);
+        }
+    } else {
+        count++;
+    }
+
+    buffer[head] = word;
+    head = (head + 1) % ENCODER_TRACE_CAPACITY;
+}
+
+/***************************************************************
+ * Static Method: trace_record
+ ****************************************************************/
+void EncoderTrace::trace_record(uint8_t encoder, uint8_t state, uint32_t nowUs) {
+    liveState[encoder] = state;
+    if (frozen || state == lastState[encoder]) {
+        return;
+    }
+    append(encoder, state, nowUs);
+}
+
+/***************************************************************
+ * Static Method: append
+ * Description:
+ *     - Stores one change, bridging long gaps with time-only
+ *       records.
+ ****************************************************************/
+void EncoderTrace::append(uint8_t encoder, uint8_t state, uint32_t nowUs) {
+    uint32_t delta = nowUs - lastUs;
+    while (delta > TRACE_MAX_DELTA_US) {
+        push(traceWord(TRACE_MAX_DELTA_US, TRACE_INDEX_GAP, 0));
+        delta -= TRACE_MAX_DELTA_US;
+    }
+    push(traceWord(delta, encoder, state));
+
+    lastUs = nowUs;
+    lastState[encoder] = state;
+}
+
+/***************************************************************
+ * Static Methods: trace_freeze / trace_resume
+ ****************************************************************/
+void EncoderTrace::trace_freeze() { frozen = true; }
+
+void EncoderTrace::trace_resume() { resync(time_us_32()); }
+
+/***************************************************************
+ * Static Method: resync
+ * Description:
+ *     - Unfreezes, first recording the current state of every
+ *       encoder that changed while frozen.
+ ****************************************************************/
+void EncoderTrace::resync(uint32_t nowUs) {
+    uint32_t irq = save_and_disable_interrupts();
+    for (uint8_t i = 0; i < encoders; i++) {
+        if (liveState[i] != lastState[i]) {
+            append(i, liveState[i], nowUs);
+        }
+    }
+    frozen = false;
+    restore_interrupts(irq);
+}
+
+uint32_t EncoderTrace::trace_getCount() { return count; }
+
+/***************************************************************
+ * Static Method: trace_dump
+ ****************************************************************/
+void EncoderTrace::trace_dump() {
+    if (!dumping) {
+        dumpWasFrozen = frozen;     // A repeated request restarts the dump
+    }
+    frozen = true;
+    dumping = true;
+
+    printf("QETRACE %d %lu %lu %u", TRACE_VERSION,
+           (unsigned long)count, (unsigned long)startUs, (unsigned)encoders);
+    for (int i = 0; i < encoders; i++) {
+        printf(" %u", (unsigned)startState[i]);
+    }
+    printf("\n");
+
+    dumpIndex = (head + ENCODER_TRACE_CAPACITY - count) % ENCODER_TRACE_CAPACITY;
+    dumpPrinted = 0;
+}
+
+/***************************************************************
+ * Static Method: trace_dumpStep
+ * Description:
+ *     - The ring cannot change while frozen, so the records
+ *       printed across calls form one consistent snapshot.
+ ****************************************************************/
+bool EncoderTrace::trace_dumpStep(uint32_t maxLines) {
+    if (!dumping) {
+        return false;
+    }
+
+    for (uint32_t line = 0; line < maxLines && dumpPrinted < count; line++) {
+        do {
+            dumpPrinted++;
+            printf("%08lx%c", (unsigned long)buffer[dumpIndex],
+                   ((dumpPrinted & 7u) == 0 || dumpPrinted == count) ? '\n' : ' ');
+            dumpIndex = (dumpIndex + 1) % ENCODER_TRACE_CAPACITY;
+        } while ((dumpPrinted & 7u) != 0 && dumpPrinted < count);
+    }
+
+    if (dumpPrinted < count) {
+        return true;
+    }
+
+    printf("QETRACE END\n");
+    dumping = false;
+    if (!dumpWasFrozen) {
+        resync(time_us_32());
+    }
+    return false;
+}
@@ -0,0 +1,128 @@
+#ifndef ENCODER_TRACE_HPP
+#define ENCODER_TRACE_HPP
+
+#include <stdint.h>
+#include "Encoder/encoder_config.hpp"
+
+/***************************************************************
+ * Edge Trace Record Format
+ * Description:
+ *     - One 32-bit word per A/B change:
+ *         bits 31..8  time since previous record [us] (24 bits)
+ *         bits  7..2  encoder index
+ *         bits  1..0  new state (A << 1) | B
+ *     - Gaps longer than TRACE_MAX_DELTA_US are bridged with
+ *       records using TRACE_INDEX_GAP, which carry time only.
+ *     - Dump format (text, over stdio):
+ *         QETRACE 1 <records> <startUs> <encoders> <state0> ...
+ *         <records as hex words, 8 per line>
+ *         QETRACE END
+ *       startUs and the start states describe the moment just
+ *       before the oldest record kept in the ring.
+ ****************************************************************/
+#define TRACE_VERSION       1
+#define TRACE_MAX_DELTA_US  0xFFFFFFu
+#define TRACE_INDEX_GAP     0x3Fu
+
+static inline uint32_t traceWord(uint32_t deltaUs, uint32_t encoder, uint32_t state) {
+    return (deltaUs << 8) | ((encoder & 0x3Fu) << 2) | (state & 3u);
+}
+static inline uint32_t traceDelta(uint32_t word) { return word >> 8; }
+static inline uint32_t traceEncoder(uint32_t word) { return (word >> 2) & 0x3Fu; }
+static inline uint8_t traceState(uint32_t word) { return static_cast<uint8_t>(word & 3u); }
+
+/***************************************************************
+ * Class: EncoderTrace
+ * Layer: HAL (Hardware Abstraction Layer)
+ * Description:
+ *     - Ring buffer recorder of timestamped A/B transitions.
+ *     - Written from the encoder IRQ / poll path; oldest records
+ *       are dropped when full so the latest history is kept.
+ *     - Compiled into EncoderHAL only with ENCODER_TRACE_ENABLE.
+ ****************************************************************/
+class EncoderTrace {
+public:
+    /***********************************************************
+     * Static Method: trace_begin
+     * Parameters:
+     *     - encoder: encoder index
+     *     - state: current A/B state
+     *     - nowUs: current time
+     * Description:
+     *     - Registers an encoder's start state (from encoder_init).
+     ***********************************************************/
+    static void trace_begin(uint8_t encoder, uint8_t state, uint32_t nowUs);
+
+    /***********************************************************
+     * Static Method: trace_record
+     * Description:
+     *     - Appends one A/B change; ignored when the state equals
+     *       the last recorded one. While frozen only the encoder's
+     *       current state is kept, for the resync on resume.
+     ***********************************************************/
+    static void trace_record(uint8_t encoder, uint8_t state, uint32_t nowUs);
+
+    /***********************************************************
+     * Static Methods: trace_freeze / trace_resume
+     * Description:
+     *     - Stop and restart recording, e.g. to keep the history
+     *       leading up to a fault until it has been dumped.
+     *     - On resume, an encoder that changed while frozen gets
+     *       one record of its current state, so later records
+     *       continue from the real pin state.
+     ***********************************************************/
+    static void trace_freeze();
+    static void trace_resume();
+
+    /***********************************************************
+     * Static Method: trace_getCount
+     * Description:
+     *     - Returns the number of records held.
+     ***********************************************************/
+    static uint32_t trace_getCount();
+
+    /***********************************************************
+     * Static Method: trace_dump
+     * Description:
+     *     - Starts a dump in the text dump format: prints the
+     *       header line; trace_dumpStep() prints the records.
+     *     - Recording is frozen until the dump completes.
+     ***********************************************************/
+    static void trace_dump();
+
+    /***********************************************************
+     * Static Method: trace_dumpStep
+     * Parameters:
+     *     - maxLines: record lines to print in this call
+     * Description:
+     *     - Continues a dump started by trace_dump(); call once
+     *       per control tick. Prints the END line when done and
+     *       returns recording to its state before the dump.
+     *     - Returns true while the dump is still in progress.
+     ***********************************************************/
+    static bool trace_dumpStep(uint32_t maxLines = ENCODER_TRACE_DUMP_LINES);
+
+private:
+    static void push(uint32_t word);
+    static void append(uint8_t encoder, uint8_t state, uint32_t nowUs);
+    static void resync(uint32_t nowUs);
+
+    static uint32_t buffer[ENCODER_TRACE_CAPACITY];     // Ring of records
+    static uint32_t head;                   // Next write index
+    static uint32_t count;                  // Records held
+    static uint32_t startUs;                // Time before oldest record
+    static uint32_t lastUs;                 // Time of newest record
+    static uint8_t encoders;                // Encoders registered
+    static uint8_t startState[ENCODER_MAX_INSTANCES];   // States before oldest record
+    static uint8_t lastState[ENCODER_MAX_INSTANCES];    // Last recorded states
+    static uint8_t liveState[ENCODER_MAX_INSTANCES];    // Current states, also while frozen
+    static volatile bool frozen;            // Recording stopped
+
+    // -------- Dump in progress --------
+    static bool dumping;
+    static bool dumpWasFrozen;              // Recording state to return to
+    static uint32_t dumpIndex;              // Next record to print
+    static uint32_t dumpPrinted;            // Records printed
+};
+
+#endif // ENCODER_TRACE_HPP
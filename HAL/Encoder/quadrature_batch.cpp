@@ -0,0 +1,104 @@
+#include "Encoder/quadrature_batch.hpp"
+#include "Encoder/quadrature_table.hpp"
+
+/***************************************************************
+ * Constructor
+ ****************************************************************/
+QuadratureBatchDecoder::QuadratureBatchDecoder()
+    : _count(0), _pinMask(0), _lastSample(0) {}
+
+/***************************************************************
+ * Method: addChannel
+ ****************************************************************/
+int QuadratureBatchDecoder::addChannel(uint32_t pinA, uint32_t pinB, uint32_t initialSample) {
+    if (_count >= ENCODER_MAX_INSTANCES) {
+        return -1;
+    }
+
+    QuadratureChannel& ch = _channels[_count];
+    ch.pinA = pinA;
+    ch.pinB = pinB;
+    ch.pinMask = (1u << pinA) | (1u << pinB);
+    ch.lastState = quadratureState(initialSample, pinA, pinB);
+    ch.ticks = 0;
+    ch.edges = 0;
+    ch.errors = 0;
+
+    _pinMask |= ch.pinMask;
+    _lastSample = initialSample;
+    return _count++;
+}
+
+/***************************************************************
+ * Method: decodeSample
+ * Description:
+ *     - Steps only the channels whose pins changed.
+ ****************************************************************/
+inline void QuadratureBatchDecoder::decodeSample(uint32_t sample, uint32_t changed) {
+    for (int i = 0; i < _count; i++) {
+        QuadratureChannel& ch = _channels[i];
+        if (changed & ch.pinMask) {
+            uint8_t state = quadratureState(sample, ch.pinA, ch.pinB);
+            int8_t step = quadratureTable[(ch.lastState << 2) | state];
+
+            if (step == QUADRATURE_INVALID) {
+                ch.errors++;
+            } else {
+                ch.ticks += step;
+                ch.edges++;
+            }
+            ch.lastState = state;
+        }
+    }
+}
+
+/***************************************************************
+ * Method: decode
+ ****************************************************************/
+void QuadratureBatchDecoder::decode(const uint32_t* samples, size_t count) {
+    const uint32_t mask = _pinMask;
+    uint32_t prev = _lastSample;
+    size_t i = 0;
+
+    while (i < count) {
+        // Four samples with no encoder pin change cost one compare
+        if (i + 4 <= count) {
+            uint32_t diff = (samples[i] ^ prev) |
+                            (samples[i + 1] ^ samples[i]) |
+                            (samples[i + 2] ^ samples[i + 1]) |
+                            (samples[i + 3] ^ samples[i + 2]);
+            if ((diff & mask) == 0) {
+                prev = samples[i + 3];
+                i += 4;
+                continue;
+            }
+        }
+
+        uint32_t sample = samples[i++];
+        uint32_t changed = (sample ^ prev) & mask;
+        if (changed) {
+            decodeSample(sample, changed);
+        }
+        prev = sample;
+    }
+
+    _lastSample = prev;
+}
+
+/***************************************************************
+ * Method: resync
+ ****************************************************************/
+void QuadratureBatchDecoder::resync(uint32_t sample) {
+    for (int i = 0; i < _count; i++) {
+        QuadratureChannel& ch = _channels[i];
+        ch.lastState = quadratureState(sample, ch.pinA, ch.pinB);
+    }
+    _lastSample = sample;
+}
+
+/***************************************************************
+ * Getter Methods
+ ****************************************************************/
+QuadratureChannel& QuadratureBatchDecoder::channel(int index) { return _channels[index]; }
+
+int QuadratureBatchDecoder::channelCount() const { return _count; }
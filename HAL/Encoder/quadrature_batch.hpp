@@ -0,0 +1,92 @@
+#ifndef QUADRATURE_BATCH_HPP
+#define QUADRATURE_BATCH_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Encoder/encoder_config.hpp"
+
+/***************************************************************
+ * Struct: QuadratureChannel
+ * Description:
+ *     - Decode state of one encoder inside a batch decoder.
+ *     - ticks, edges and errors accumulate until the owner
+ *       drains them.
+ ****************************************************************/
+struct QuadratureChannel {
+    uint32_t pinA, pinB;        // GPIO bit positions in a sample
+    uint32_t pinMask;           // (1 << pinA) | (1 << pinB)
+    uint8_t lastState;          // Previous state (A << 1) | B
+    int32_t ticks;              // Net steps decoded
+    uint32_t edges;             // Valid edges decoded
+    uint32_t errors;            // Invalid transitions (missed edges)
+};
+
+/***************************************************************
+ * Class: QuadratureBatchDecoder
+ * Layer: HAL (hardware independent)
+ * Description:
+ *     - Decodes every encoder from an array of GPIO input
+ *       register samples in one pass.
+ *     - Runs of samples with no encoder pin change, the common
+ *       case at a fixed sample rate, are skipped four at a time
+ *       with a single OR-reduced compare.
+ *     - Plain C++, no SDK calls: usable from the DMA IRQ and on
+ *       the host against recorded waveforms.
+ ****************************************************************/
+class QuadratureBatchDecoder {
+public:
+    /***********************************************************
+     * Constructor: QuadratureBatchDecoder
+     * Description:
+     *     - Starts with no channels.
+     ***********************************************************/
+    QuadratureBatchDecoder();
+
+    /***********************************************************
+     * Method: addChannel
+     * Parameters:
+     *     - pinA, pinB: GPIO numbers of channels A and B
+     *     - initialSample: GPIO snapshot giving the start state
+     * Description:
+     *     - Returns the channel index, or -1 when full.
+     ***********************************************************/
+    int addChannel(uint32_t pinA, uint32_t pinB, uint32_t initialSample);
+
+    /***********************************************************
+     * Method: decode
+     * Parameters:
+     *     - samples: GPIO input register samples, oldest first
+     *     - count: number of samples
+     * Description:
+     *     - Continues from the last sample of the previous call.
+     ***********************************************************/
+    void decode(const uint32_t* samples, size_t count);
+
+    /***********************************************************
+     * Method: resync
+     * Parameters:
+     *     - sample: GPIO snapshot to continue from
+     * Description:
+     *     - Takes the sample as every channel's state without
+     *       decoding a step to it, after samples were lost.
+     ***********************************************************/
+    void resync(uint32_t sample);
+
+    /***********************************************************
+     * Method: channel / channelCount
+     * Description:
+     *     - Access to per-channel results.
+     ***********************************************************/
+    QuadratureChannel& channel(int index);
+    int channelCount() const;
+
+private:
+    inline void decodeSample(uint32_t sample, uint32_t changed);
+
+    QuadratureChannel _channels[ENCODER_MAX_INSTANCES];
+    int _count;                 // Channels in use
+    uint32_t _pinMask;          // Union of all channel pins
+    uint32_t _lastSample;       // Last sample decoded
+};
+
+#endif // QUADRATURE_BATCH_HPP
@@ -0,0 +1,36 @@
+#ifndef QUADRATURE_TABLE_HPP
+#define QUADRATURE_TABLE_HPP
+
+#include <stdint.h>
+
+/***************************************************************
+ * Quadrature State Decode Table
+ * Description:
+ *     - A 2-bit encoder state is (A << 1) | B.
+ *     - Forward (A leads B) cycles 0 -> 2 -> 3 -> 1 -> 0.
+ *     - Index with (lastState << 2) | newState to get the step:
+ *       +1 forward, -1 backward, 0 no change.
+ *     - QUADRATURE_INVALID marks both channels changing at once,
+ *       i.e. an edge was missed; no step is counted for it.
+ ****************************************************************/
+
+#define QUADRATURE_INVALID 2
+
+static const int8_t quadratureTable[16] = {
+    /* last 0 */  0, -1, +1, QUADRATURE_INVALID,
+    /* last 1 */ +1,  0, QUADRATURE_INVALID, -1,
+    /* last 2 */ -1, QUADRATURE_INVALID,  0, +1,
+    /* last 3 */ QUADRATURE_INVALID, +1, -1,  0,
+};
+
+/***************************************************************
+ * Function: quadratureState
+ * Description:
+ *     - Extracts the 2-bit state of one encoder from a GPIO
+ *       input register snapshot.
+ ****************************************************************/
+static inline uint8_t quadratureState(uint32_t gpioWord, uint32_t pinA, uint32_t pinB) {
+    return static_cast<uint8_t>((((gpioWord >> pinA) & 1u) << 1) | ((gpioWord >> pinB) & 1u));
+}
+
+#endif // QUADRATURE_TABLE_HPP
@@ -0,0 +1,57 @@
+#include "Flash/flash_storage.hpp"
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+
+/***************************************************************
+ * Constructor
+ ****************************************************************/
+FlashStorage::FlashStorage()
+    : _base(PICO_FLASH_SIZE_BYTES - FLASH_PARAM_SECTORS * FLASH_SECTOR_SIZE) {}
+
+/***************************************************************
+ * Geometry
+ ****************************************************************/
+uint32_t FlashStorage::nv_size() const { return FLASH_PARAM_SECTORS * FLASH_SECTOR_SIZE; }
+
+uint32_t FlashStorage::nv_eraseSize() const { return FLASH_SECTOR_SIZE; }
+
+/***************************************************************
+ * Method: nv_read
+ ****************************************************************/
+bool FlashStorage::nv_read(uint32_t offset, void* dst, uint32_t length) {
+    if (offset > nv_size() || length > nv_size() - offset) {
+        return false;
+    }
+    memcpy(dst, reinterpret_cast<const void*>(XIP_BASE + _base + offset), length);
+    return true;
+}
+
+/***************************************************************
+ * Method: nv_erase
+ ****************************************************************/
+bool FlashStorage::nv_erase(uint32_t offset, uint32_t length) {
+    if (offset > nv_size() || length > nv_size() - offset ||
+        offset % FLASH_SECTOR_SIZE != 0 || length % FLASH_SECTOR_SIZE != 0) {
+        return false;
+    }
+    uint32_t irq = save_and_disable_interrupts();
+    flash_range_erase(_base + offset, length);
+    restore_interrupts(irq);
+    return true;
+}
+
+/***************************************************************
+ * Method: nv_program
+ ****************************************************************/
+bool FlashStorage::nv_program(uint32_t offset, const void* src, uint32_t length) {
+    if (offset > nv_size() || length > nv_size() - offset ||
+        offset % FLASH_PAGE_SIZE != 0 || length % FLASH_PAGE_SIZE != 0) {
+        return false;
+    }
+    uint32_t irq = save_and_disable_interrupts();
+    flash_range_program(_base + offset, static_cast<const uint8_t*>(src), length);
+    restore_interrupts(irq);
+    return true;
+}
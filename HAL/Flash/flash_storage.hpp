@@ -0,0 +1,40 @@
+#ifndef FLASH_STORAGE_HPP
+#define FLASH_STORAGE_HPP
+
+#include "Flash/nv_storage.hpp"
+
+/***************************************************************
+ * Parameter Flash Region
+ * Description:
+ *     - The last FLASH_PARAM_SECTORS sectors of the on-board
+ *       flash are reserved for parameters. The firmware image
+ *       is far smaller, so nothing is linked there.
+ ****************************************************************/
+#define FLASH_PARAM_SECTORS 2
+
+/***************************************************************
+ * Class: FlashStorage
+ * Layer: HAL (Hardware Abstraction Layer)
+ * Description:
+ *     - NvStorage on the reserved sectors of the XIP flash.
+ *     - Reads are plain copies from the memory-mapped flash.
+ *     - Erase and program run with interrupts off, as the flash
+ *       cannot be executed from meanwhile: an erase stalls all
+ *       IRQs for tens of milliseconds. Core 1 must not be
+ *       running code from flash while they are called.
+ ****************************************************************/
+class FlashStorage : public NvStorage {
+public:
+    FlashStorage();
+
+    uint32_t nv_size() const override;
+    uint32_t nv_eraseSize() const override;
+    bool nv_read(uint32_t offset, void* dst, uint32_t length) override;
+    bool nv_erase(uint32_t offset, uint32_t length) override;
+    bool nv_program(uint32_t offset, const void* src, uint32_t length) override;
+
+private:
+    uint32_t _base;     // Region offset from the start of flash
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef NV_STORAGE_HPP
+#define NV_STORAGE_HPP
+
+#include <stdint.h>
+
+/***************************************************************
+ * Class: NvStorage
+ * Layer: HAL (Hardware Abstraction Layer)
+ * Description:
+ *     - Non-volatile storage region with NOR flash semantics:
+ *       erase sets whole erase blocks to 0xFF, program can only
+ *       clear bits.
+ *     - Offsets are relative to the start of the region.
+ *       Erase offsets/lengths are multiples of nv_eraseSize();
+ *       program offsets/lengths are multiples of 256 bytes.
+ *     - Implemented by FlashStorage on the Pico and by a file
+ *       on the host, so users can be tested on Linux.
+ ****************************************************************/
+class NvStorage {
+public:
+    virtual ~NvStorage() {}
+
+    /***********************************************************
+     * Methods: nv_size / nv_eraseSize
+     * Description:
+     *     - Region size and erase block size in bytes.
+     ***********************************************************/
+    virtual uint32_t nv_size() const = 0;
+    virtual uint32_t nv_eraseSize() const = 0;
+
+    /***********************************************************
+     * Methods: nv_read / nv_erase / nv_program
+     * Description:
+     *     - Return false on an out-of-range or misaligned request,
+     *       or when the medium reports an error.
+     ***********************************************************/
+    virtual bool nv_read(uint32_t offset, void* dst, uint32_t length) = 0;
+    virtual bool nv_erase(uint32_t offset, uint32_t length) = 0;
+    virtual bool nv_program(uint32_t offset, const void* src, uint32_t length) = 0;
+};
+
+#endif
@@ -0,0 +1,190 @@
+/***************************************************************
+ *  File: cpu_profiler.cpp
+ *  Layer: HAL (Hardware Abstraction Layer)
+ *  Description:
+ *      - Per-core CPU time accounting by zone, with rolling and
+ *        peak-window utilisation.
+ ****************************************************************/
+
+#include "Profiler/cpu_profiler.hpp"
+
+#if CPU_PROFILER_ENABLE
+
+#include <stdio.h>
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+static const uint8_t ZONE_IDLE = static_cast<uint8_t>(ProfileZone::IDLE);
+static const uint8_t ZONE_OTHER = static_cast<uint8_t>(ProfileZone::OTHER);
+
+// ---------------------------
+// Static members
+// ---------------------------
+CpuProfiler::CoreState CpuProfiler::cores[CPU_PROFILER_CORES];
+
+// ---------------------------
+// Method: charge
+// ---------------------------
+// Description:
+//     - Adds the time since the last zone change to the zone
+//       the core has been in. Nesting deeper than
+//       CPU_PROFILER_DEPTH is charged to the deepest tracked zone.
+void CpuProfiler::charge(CoreState& s, uint32_t nowUs) {
+    uint8_t zone = ZONE_OTHER;
+    if (s.depth > 0) {
+        zone = s.stack[(s.depth < CPU_PROFILER_DEPTH ? s.depth : CPU_PROFILER_DEPTH) - 1];
+    }
+    s.current[zone] += nowUs - s.lastUs;
+    s.lastUs = nowUs;
+
+    if (nowUs - s.windowStartUs >= CPU_PROFILER_WINDOW_US) {
+        closeWindow(s, nowUs);
+    }
+}
+
+// ---------------------------
+// Method: closeWindow
+// ---------------------------
+// Description:
+//     - Replaces the oldest history window with the open one and
+//       keeps the rolling sums in step, so a report is O(zones).
+void CpuProfiler::closeWindow(CoreState& s, uint32_t nowUs) {
+    s.seq = s.seq + 1;
+    __dmb();
+
+    uint32_t lengthUs = nowUs - s.windowStartUs;
+    uint32_t* slot = s.history[s.next];
+    for (int z = 0; z < CPU_PROFILER_ZONES; z++) {
+        s.sum[z] += s.current[z] - slot[z];
+        slot[z] = s.current[z];
+        s.current[z] = 0;
+    }
+    s.sumUs += lengthUs - s.historyUs[s.next];
+    s.historyUs[s.next] = lengthUs;
+    s.next = (s.next + 1) % CPU_PROFILER_HISTORY;
+
+    if (lengthUs > 0) {
+        uint32_t busy = lengthUs - slot[ZONE_IDLE];
+        uint32_t permille = static_cast<uint32_t>(static_cast<uint64_t>(busy) * 1000u / lengthUs);
+        if (permille > s.peakPermille) s.peakPermille = permille;
+    }
+    s.windows++;
+    s.windowStartUs = nowUs;
+
+    __dmb();
+    s.seq = s.seq + 1;
+}
+
+// ---------------------------
+// Methods: profiler_enter / profiler_exit
+// ---------------------------
+void CpuProfiler::profiler_enter(ProfileZone zone) {
+    uint32_t irq = save_and_disable_interrupts();
+    CoreState& s = cores[get_core_num()];
+    charge(s, time_us_32());
+    if (s.depth < CPU_PROFILER_DEPTH) {
+        s.stack[s.depth] = static_cast<uint8_t>(zone);
+    }
+    s.depth++;
+    restore_interrupts(irq);
+}
+
+void CpuProfiler::profiler_exit() {
+    uint32_t irq = save_and_disable_interrupts();
+    CoreState& s = cores[get_core_num()];
+    charge(s, time_us_32());
+    if (s.depth > 0) {
+        s.depth--;
+    }
+    restore_interrupts(irq);
+}
+
+// ---------------------------
+// Method: profiler_getReport
+// ---------------------------
+// Description:
+//     - Copies the rolling sums, retrying if a window was closed
+//       meanwhile.
+bool CpuProfiler::profiler_getReport(uint core, CpuLoadReport& out) {
+    if (core >= CPU_PROFILER_CORES) {
+        return false;
+    }
+    const CoreState& s = cores[core];
+
+    uint32_t sum[CPU_PROFILER_ZONES];
+    uint32_t sumUs, peakPermille, windows, seq;
+    do {
+        while ((seq = s.seq) & 1u) {}
+        __dmb();
+        for (int z = 0; z < CPU_PROFILER_ZONES; z++) sum[z] = s.sum[z];
+        sumUs = s.sumUs;
+        peakPermille = s.peakPermille;
+        windows = s.windows;
+        __dmb();
+    } while (s.seq != seq);
+
+    if (windows == 0 || sumUs == 0) {
+        return false;
+    }
+
+    out.spanUs = sumUs;
+    for (int z = 0; z < CPU_PROFILER_ZONES; z++) {
+        out.percent[z] = 100.0f * sum[z] / sumUs;
+    }
+    out.loadPercent = 100.0f - out.percent[ZONE_IDLE];
+    out.peakLoadPercent = peakPermille / 10.0f;
+    out.windows = windows;
+    return true;
+}
+
+// ---------------------------
+// Method: profiler_printSummary
+// ---------------------------
+void CpuProfiler::profiler_printSummary() {
+    for (uint core = 0; core < CPU_PROFILER_CORES; core++) {
+        CpuLoadReport r;
+        if (!profiler_getReport(core, r)) {
+            continue;
+        }
+        printf("CPU%u | Load: %.1f%% (peak %.1f%%) | ISR: %.1f%% | Timers: %.1f%% | Control: %.1f%% | "
+               "Telemetry: %.1f%% | Other: %.1f%% | Idle: %.1f%%\n",
+               core, r.loadPercent, r.peakLoadPercent,
+               r.percent[static_cast<int>(ProfileZone::ENCODER_ISR)],
+               r.percent[static_cast<int>(ProfileZone::TIMER_CALLBACK)],
+               r.percent[static_cast<int>(ProfileZone::CONTROL_LOOP)],
+               r.percent[static_cast<int>(ProfileZone::TELEMETRY_IO)],
+               r.percent[ZONE_OTHER], r.percent[ZONE_IDLE]);
+    }
+}
+
+// ---------------------------
+// Method: profiler_reset
+// ---------------------------
+// Description:
+//     - Open zones are kept, so a reset from inside a zone still
+//       pairs up with its exit.
+void CpuProfiler::profiler_reset() {
+    uint32_t irq = save_and_disable_interrupts();
+    CoreState& s = cores[get_core_num()];
+    s.seq = s.seq + 1;
+    __dmb();
+
+    for (int z = 0; z < CPU_PROFILER_ZONES; z++) {
+        s.current[z] = 0;
+        s.sum[z] = 0;
+        for (int h = 0; h < CPU_PROFILER_HISTORY; h++) s.history[h][z] = 0;
+    }
+    for (int h = 0; h < CPU_PROFILER_HISTORY; h++) s.historyUs[h] = 0;
+    s.next = 0;
+    s.sumUs = 0;
+    s.peakPermille = 0;
+    s.windows = 0;
+    s.lastUs = time_us_32();
+    s.windowStartUs = s.lastUs;
+
+    __dmb();
+    s.seq = s.seq + 1;
+    restore_interrupts(irq);
+}
+
+#endif // CPU_PROFILER_ENABLE
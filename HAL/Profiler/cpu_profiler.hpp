@@ -0,0 +1,161 @@
+#ifndef CPU_PROFILER_HPP
+#define CPU_PROFILER_HPP
+
+#include <stdint.h>
+#include "pico.h"
+
+/***************************************************************
+ * CPU Profiler Configuration
+ * Description:
+ *     - CPU_PROFILER_ENABLE 0 removes the profiler: the PROFILE_*
+ *       macros expand to nothing and no state is linked in.
+ *     - Off by default: enabled, every zone (one per edge IRQ)
+ *       costs two critical sections and two timer reads. Build
+ *       with -DCPU_PROFILER_ENABLE=1 to measure load;
+ *       bench_suite_profiled reports the cost per zone.
+ *     - Time is closed into windows of CPU_PROFILER_WINDOW_US;
+ *       the rolling figures average the last
+ *       CPU_PROFILER_HISTORY windows.
+ ****************************************************************/
+#ifndef CPU_PROFILER_ENABLE
+#define CPU_PROFILER_ENABLE      0
+#endif
+#define CPU_PROFILER_CORES       2
+#define CPU_PROFILER_WINDOW_US   100000     // One window per 100 ms
+#define CPU_PROFILER_HISTORY     10         // Rolling average over 1 s
+#define CPU_PROFILER_DEPTH       4          // Nesting levels tracked
+
+/***************************************************************
+ * Enum: ProfileZone
+ * Description:
+ *     - What a core is spending its time on. Time outside any
+ *       zone is OTHER (thread code not tagged); everything but
+ *       IDLE counts as load.
+ ****************************************************************/
+enum class ProfileZone : uint8_t {
+    ENCODER_ISR,        // Edge IRQ, polling and DMA decode
+    TIMER_CALLBACK,     // Sampling alarm and housekeeping timers
+    CONTROL_LOOP,       // Commands, PID, motor output
+    TELEMETRY_IO,       // stdio output
+    IDLE,               // Sleeping in WFE
+    OTHER,
+    COUNT
+};
+
+#define CPU_PROFILER_ZONES static_cast<int>(ProfileZone::COUNT)
+
+/***************************************************************
+ * Struct: CpuLoadReport
+ * Description:
+ *     - Rolling utilisation of one core.
+ ****************************************************************/
+struct CpuLoadReport {
+    uint32_t spanUs;                        // Time covered by the rolling figures
+    float percent[CPU_PROFILER_ZONES];      // Share of spanUs per zone
+    float loadPercent;                      // Share of spanUs not IDLE
+    float peakLoadPercent;                  // Busiest single window since reset
+    uint32_t windows;                       // Windows closed since reset
+};
+
+#if CPU_PROFILER_ENABLE
+
+/***************************************************************
+ * Class: CpuProfiler
+ * Layer: HAL (Hardware Abstraction Layer)
+ * Description:
+ *     - Attributes each core's time to the zone it is in, with
+ *       a small per-core stack so an IRQ taken inside a zone is
+ *       charged to the IRQ and not to the interrupted zone.
+ *     - Time is read from the 1 us system timer at each zone
+ *       change; short zones are quantised to 1 us, which
+ *       averages out over a window.
+ *     - Windows are closed by the zone change that crosses the
+ *       window end, so no timer of its own is needed.
+ *     - Reports are read under a sequence counter, so another
+ *       core (or an IRQ closing a window) never tears them.
+ ****************************************************************/
+class CpuProfiler {
+public:
+    /***********************************************************
+     * Static Methods: profiler_enter / profiler_exit
+     * Description:
+     *     - Start and end a zone on the calling core; calls must
+     *       pair up. Safe from IRQ and thread context.
+     ***********************************************************/
+    static void profiler_enter(ProfileZone zone);
+    static void profiler_exit();
+
+    /***********************************************************
+     * Static Method: profiler_getReport
+     * Parameters:
+     *     - core: core number
+     *     - out: rolling figures of that core
+     * Description:
+     *     - Returns false until the core has closed a window.
+     ***********************************************************/
+    static bool profiler_getReport(uint core, CpuLoadReport& out);
+
+    /***********************************************************
+     * Static Method: profiler_printSummary
+     * Description:
+     *     - Prints one line per core that has closed a window.
+     ***********************************************************/
+    static void profiler_printSummary();
+
+    /***********************************************************
+     * Static Method: profiler_reset
+     * Description:
+     *     - Clears history and peak of the calling core and starts
+     *       a new window now.
+     ***********************************************************/
+    static void profiler_reset();
+
+private:
+    struct CoreState {
+        volatile uint32_t seq;                  // Odd while a window is being closed
+        uint8_t stack[CPU_PROFILER_DEPTH];      // Open zones, innermost last
+        uint8_t depth;                          // May exceed CPU_PROFILER_DEPTH
+        uint32_t lastUs;                        // Last zone change
+        uint32_t windowStartUs;
+        uint32_t current[CPU_PROFILER_ZONES];   // Open window
+        uint32_t history[CPU_PROFILER_HISTORY][CPU_PROFILER_ZONES];
+        uint32_t historyUs[CPU_PROFILER_HISTORY];
+        uint8_t next;                           // Oldest history slot
+        uint32_t sum[CPU_PROFILER_ZONES];       // Sum over history
+        uint32_t sumUs;
+        uint32_t peakPermille;                  // Busiest window load
+        uint32_t windows;
+    };
+
+    static void charge(CoreState& s, uint32_t nowUs);
+    static void closeWindow(CoreState& s, uint32_t nowUs);
+
+    static CoreState cores[CPU_PROFILER_CORES];
+};
+
+/***************************************************************
+ * Class: CpuProfileScope
+ * Description:
+ *     - Enters a zone for the lifetime of the object.
+ ****************************************************************/
+class CpuProfileScope {
+public:
+    explicit CpuProfileScope(ProfileZone zone) { CpuProfiler::profiler_enter(zone); }
+    ~CpuProfileScope() { CpuProfiler::profiler_exit(); }
+    CpuProfileScope(const CpuProfileScope&) = delete;
+    CpuProfileScope& operator=(const CpuProfileScope&) = delete;
+};
+
+#define PROFILE_ZONE(zone)  CpuProfileScope _profileScope(ProfileZone::zone)
+#define PROFILE_ENTER(zone) CpuProfiler::profiler_enter(ProfileZone::zone)
+#define PROFILE_EXIT()      CpuProfiler::profiler_exit()
+
+#else
+
+#define PROFILE_ZONE(zone)  ((void)0)
+#define PROFILE_ENTER(zone) ((void)0)
+#define PROFILE_EXIT()      ((void)0)
+
+#endif // CPU_PROFILER_ENABLE
+
+#endif // CPU_PROFILER_HPP
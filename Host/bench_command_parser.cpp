@@ -0,0 +1,126 @@
+/***************************************************************
+ *  File: bench_command_parser.cpp
+ *  Description:
+ *      - Checks CommandParser on valid, malformed, overlong and
+ *        split lines, the full-queue policy and the non-blocking
+ *        stdio poll on the simulated SDK.
+ *      - Reports parser throughput in commands per second.
+ ****************************************************************/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "sim.hpp"
+#include "test_check.hpp"
+#include "Command/command_parser.hpp"
+
+static void feed(CommandParser& p, const char* text) {
+    while (*text) p.cmd_feed(*text++);
+}
+
+static bool near(float a, float b) { return std::fabs(a - b) < 1e-4f * (1.0f + std::fabs(b)); }
+
+static void testParse() {
+    CommandParser p;
+    Command c;
+
+    feed(p, "S 0 -120.5\n");
+    check(p.cmd_pop(c) && c.type == CommandType::SET_SPEED && c.index == 0 && near(c.args[0], -120.5f),
+          "set speed");
+
+    feed(p, "g 0 0.5 14.7 1e-3\r\n");
+    check(p.cmd_pop(c) && c.type == CommandType::SET_GAINS && near(c.args[0], 0.5f) &&
+          near(c.args[1], 14.7f) && near(c.args[2], 0.001f), "set gains");
+    check(!p.cmd_pop(c), "CRLF is one line");
+
+    feed(p, "T 1 5\nT 0\nQ 1\nD\n");
+    check(p.cmd_pop(c) && c.type == CommandType::TELEMETRY && c.index == 1 && near(c.args[0], 5.0f),
+          "telemetry with period");
+    check(p.cmd_pop(c) && c.type == CommandType::TELEMETRY && c.index == 0, "telemetry off");
+    check(p.cmd_pop(c) && c.type == CommandType::QUERY && c.index == 1, "query");
+    check(p.cmd_pop(c) && c.type == CommandType::DUMP_TRACE, "dump");
+
+    feed(p, "C 1 1200 3.25 1\nW\nF 0\n");
+    check(p.cmd_pop(c) && c.type == CommandType::SET_CALIBRATION && c.index == 1 && near(c.args[0], 1200.0f) &&
+          near(c.args[1], 3.25f) && near(c.args[2], 1.0f), "calibration");
+    check(p.cmd_pop(c) && c.type == CommandType::SAVE_PARAMS, "save");
+    check(p.cmd_pop(c) && c.type == CommandType::CLEAR_FAULT && c.index == 0, "clear fault");
+
+    // Exponents saturate: no unbounded scaling loop, tiny values are 0
+    feed(p, "S 0 1e-999999999\nS 0 2.5e+0000000000001\nS 0 1e38\n");
+    check(p.cmd_pop(c) && c.type == CommandType::SET_SPEED && c.args[0] == 0.0f, "huge negative exponent");
+    check(p.cmd_pop(c) && c.type == CommandType::SET_SPEED && near(c.args[0], 25.0f), "leading zeros in exponent");
+    check(p.cmd_pop(c) && c.type == CommandType::SET_SPEED && near(c.args[0], 1e38f), "largest decade");
+
+    const char* bad[] = {"X 1\n", "S 0\n", "S 0 12abc\n", "G 0 1 2\n", "Q -1\n", "S 0 1 2 3 4 5\n", "S\n", "C 0 330 3\n", "W 1\n", "F\n",
+                         "S 0 1e40\n", "S 0 -1e999999999\n", "G 0 1 1e39 0\n",
+                         "S 0 99999999999999999999999999999999999999999\n"};
+    for (const char* line : bad) {
+        feed(p, line);
+        check(p.cmd_pop(c) && c.type == CommandType::INVALID, line);
+    }
+
+    // Overlong line: one INVALID, parser recovers on the next line
+    for (int i = 0; i < COMMAND_LINE_MAX * 2; i++) p.cmd_feed('1');
+    feed(p, "\nQ 0\n");
+    check(p.cmd_pop(c) && c.type == CommandType::INVALID, "overlong line");
+    check(p.cmd_pop(c) && c.type == CommandType::QUERY && c.index == 0, "recovery after overlong line");
+
+    // Line split across polls
+    feed(p, "S 0 4");
+    check(!p.cmd_pop(c), "partial line not queued");
+    feed(p, "2\n");
+    check(p.cmd_pop(c) && near(c.args[0], 42.0f), "split line");
+
+    // Full queue keeps the oldest commands
+    for (int i = 0; i < COMMAND_QUEUE_DEPTH + 3; i++) feed(p, "Q 0\n");
+    int popped = 0;
+    while (p.cmd_pop(c)) popped++;
+    check(popped == COMMAND_QUEUE_DEPTH && p.cmd_getDropped() == 3, "queue overflow");
+}
+
+static void testStdio() {
+    sim::reset();
+    CommandParser p;
+    Command c;
+
+    check(p.cmd_pollStdio() == 0, "empty stdio returns at once");
+
+    sim::pushInput("S 0 100\nQ 1\n");
+    check(p.cmd_pollStdio(4) == 4, "budget bounds one poll");
+    check(!p.cmd_pop(c), "nothing complete after budget");
+    p.cmd_pollStdio();
+    check(p.cmd_pop(c) && c.type == CommandType::SET_SPEED, "stdio set speed");
+    check(p.cmd_pop(c) && c.type == CommandType::QUERY, "stdio query");
+}
+
+static volatile float sink;
+
+int main() {
+    testParse();
+    testStdio();
+
+    // Throughput: a realistic command mix, parsed and popped
+    static const char* mix[] = {"S 0 -120.5\n", "G 0 0.25 14.7 0.001\n", "T 1 10\n", "Q 1\n", "D\n"};
+    const int kCommands = 2000000;
+    CommandParser p;
+    Command c;
+    int parsed = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCommands; i++) {
+        for (const char* t = mix[i % 5]; *t; t++) p.cmd_feed(*t);
+        if (p.cmd_pop(c)) {
+            sink = c.args[0];
+            parsed++;
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    check(parsed == kCommands, "every benchmark command parsed");
+    double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+    printf("%-10s %14s %14s\n", "commands", "Mcmd/s", "ns/cmd");
+    printf("%-10d %14.2f %14.1f\n", kCommands, kCommands / us, us * 1000.0 / kCommands);
+
+    return test_result();
+}
@@ -0,0 +1,81 @@
+/***************************************************************
+ *  File: bench_pid.cpp
+ *  Description:
+ *      - Host benchmark of the controller library.
+ *      - Reports the cost of one control step for each PID form
+ *        and for MotorPID as configured in PID_config.hpp, with and
+ *        without a gain schedule.
+ ****************************************************************/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "PID.hpp"
+
+static const int kSamples = 4096;          // Recorded measurement sequence length
+static const int kSteps   = 4000000;       // Control steps per variant
+
+static float measurements[kSamples];
+static volatile float sink;                // Keeps results observable
+
+// Step response of a noisy first-order motor, in RPM
+static void fillMeasurements() {
+    float rpm = 0.0f;
+    unsigned seed = 12345;
+    for (int i = 0; i < kSamples; i++) {
+        rpm += (120.0f - rpm) * 0.05f;
+        seed = seed * 1103515245u + 12345u;
+        measurements[i] = rpm + ((seed >> 16) % 200) * 0.01f - 1.0f;
+    }
+}
+
+static PIDConfig benchConfig() {
+    PIDConfig cfg;
+    cfg.kp = 0.5f;
+    cfg.ki = 5.0f;
+    cfg.kd = 0.01f;
+    cfg.dt = 0.01f;
+    cfg.out_min = -MAX_RPM;
+    cfg.out_max = MAX_RPM;
+    cfg.d_filter_tau = 0.02f;
+    cfg.kaw = 10.0f;
+    cfg.slew_rate = 2000.0f;
+    return cfg;
+}
+
+template <typename Step>
+static void run(const char* name, Step step) {
+    auto start = std::chrono::steady_clock::now();
+    float acc = 0.0f;
+    for (int i = 0; i < kSteps; i++) {
+        acc += step(measurements[i & (kSamples - 1)]);
+    }
+    auto end = std::chrono::steady_clock::now();
+    sink = acc;
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    printf("%-16s %8.2f ns/step\n", name, ns / kSteps);
+}
+
+int main() {
+    fillMeasurements();
+
+    PIDController<PositionalPID> positional(benchConfig());
+    run("positional", [&](float y) { return positional.step(120.0f, y, 0.0f); });
+
+    PIDController<IncrementalPID> incremental(benchConfig());
+    run("incremental", [&](float y) { return incremental.step(120.0f, y, 0.0f); });
+
+    MotorPID::PIDINPUT in = {0.5f, 5.0f, 0.01f, 0.01f, 120.0f, 1.0f, 0.02f, 10.0f, 2000.0f};
+    MotorPID motor(&in);
+    run("MotorPID", [&](float y) { return motor.UpdateThrottle(y); });
+
+    // Eight-point table against measured speed: one lookup per step
+    PIDGains table[GAIN_SCHEDULE_MAX_POINTS];
+    for (int i = 0; i < GAIN_SCHEDULE_MAX_POINTS; i++) table[i] = PIDGains{0.5f + 0.1f * i, 5.0f - 0.3f * i, 0.01f};
+    MotorPID scheduled(&in);
+    scheduled.SetGainSchedule(MotorPID::ScheduleVariable::MEASURED_RPM, 0.0f, MAX_RPM, table, GAIN_SCHEDULE_MAX_POINTS);
+    run("MotorPID sched", [&](float y) { return scheduled.UpdateThrottle(y); });
+
+    return 0;
+}
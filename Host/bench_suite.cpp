@@ -0,0 +1,417 @@
+/***************************************************************
+ *  File: bench_suite.cpp
+ *  Description:
+ *      - Regression suite for the encoder and control hot paths,
+ *        run against the simulated SDK:
+ *          - quadrature decode through encoder_gpioCallback:
+ *            forward, reverse, jitter, missed-edge and
+ *            interleaved two-encoder sequences
+ *          - decode throughput and GPIO IRQ dispatch cost for
+ *            1 .. ENCODER_MAX_INSTANCES registered encoders
+ *          - EncoderService sample tick (update + publish)
+ *          - MotorPID::ComputePID and UpdateThrottle
+ *          - with CPU_PROFILER_ENABLE: one profiled zone
+ *            (enter + exit) of each ProfileZone
+ *      - Each cost is the best of kRepeats runs; costs of the
+ *        simulator itself (pin writes, timer dispatch) are
+ *        measured alone and subtracted.
+ *      - Exits non-zero when a correctness test fails, or when
+ *        a benchmark is slower than the baseline by more than
+ *        --max-slowdown.
+ *
+ *  Usage:
+ *      bench_suite [--json file] [--csv file]
+ *                  [--baseline file.csv [--max-slowdown 0.25]]
+ *
+ *      The CSV of one commit is the baseline of the next:
+ *          kind,name,value,unit
+ ****************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "sim.hpp"
+#include "quadrature_gen.hpp"
+#include "hardware/sync.h"
+#include "Encoder/encoder_hal.hpp"
+#include "Encoder/encoder_service.hpp"
+#include "Profiler/cpu_profiler.hpp"
+#include "PID.hpp"
+
+static const uint kPins[ENCODER_MAX_INSTANCES][2] = {
+    {ENCODER1_PIN_A, ENCODER1_PIN_B},
+    {ENCODER2_PIN_A, ENCODER2_PIN_B},
+};
+static const int kRepeats = 5;
+static const long kEdges = 1000000;                 // Per decode / dispatch run
+static const long kSamples = 200000;                // Per service run
+static const long kSteps = 2000000;                 // Per PID run
+
+static volatile float sink;                         // Keeps results observable
+
+/***************************************************************
+ * Results
+ ****************************************************************/
+struct Result {
+    std::string kind;       // "bench" or "test"
+    std::string name;
+    double value;
+    const char* unit;
+};
+
+static std::vector<Result> results;
+static bool allPassed = true;
+
+static void bench(const std::string& name, double value, const char* unit) {
+    results.push_back({"bench", name, value, unit});
+    printf("  %-34s %12.2f %s\n", name.c_str(), value, unit);
+}
+
+static void test(const char* name, bool pass) {
+    results.push_back({"test", name, pass ? 1.0 : 0.0, "pass"});
+    printf("  %-34s %12s\n", name, pass ? "PASS" : "FAIL");
+    allPassed &= pass;
+}
+
+// Best of kRepeats: ns per operation of run(ops)
+template <typename Run>
+static double nsPerOp(long ops, Run run) {
+    double best = 1e300;
+    for (int r = 0; r < kRepeats; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        run(ops);
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / ops);
+    }
+    return best;
+}
+
+/***************************************************************
+ * Decode throughput and IRQ dispatch
+ * Description:
+ *     - Pins change with interrupts disabled, then the registered
+ *       callback is called as the IRQ would call it. The glitch
+ *       filter is off: the virtual clock does not move.
+ ****************************************************************/
+static double pinWriteNs(const QuadratureGen& gen) {
+    uint32_t mask = gen.mask();
+    return nsPerOp(kEdges, [&](long n) {
+        for (long i = 0; i < n; i++) {
+            uint32_t irq = save_and_disable_interrupts();
+            sim::setPins(mask, gen.levels(static_cast<int>(i)));
+            restore_interrupts(irq);
+        }
+    });
+}
+
+static double dispatchNs(int index, const QuadratureGen& gen, double pinNs) {
+    gpio_irq_callback_t callback = sim::gpioIrqCallback();
+    uint32_t mask = gen.mask();
+    double ns = nsPerOp(kEdges, [&](long n) {
+        for (long i = 0; i < n; i++) {
+            uint32_t irq = save_and_disable_interrupts();
+            sim::setPins(mask, gen.levels(static_cast<int>(i)));
+            restore_interrupts(irq);
+            callback(kPins[index][i & 1], GPIO_IRQ_EDGE_RISE);
+        }
+    });
+    return std::max(ns - pinNs, 0.0);
+}
+
+/***************************************************************
+ * EncoderService sample tick
+ * Description:
+ *     - The service timer fires once per advance of the virtual
+ *       clock; an empty repeating timer gives the simulator's
+ *       own dispatch cost.
+ ****************************************************************/
+static bool emptyTimer(struct repeating_timer*) { return true; }
+
+static double serviceTickNs(EncoderService& service) {
+    const uint64_t periodUs = ENCODER_SAMPLE_PERIOD_MS * 1000ull;
+    auto advance = [&](long n) {
+        for (long i = 0; i < n; i++) sim::advanceUs(periodUs);
+    };
+
+    struct repeating_timer timer;
+    add_repeating_timer_ms(-ENCODER_SAMPLE_PERIOD_MS, emptyTimer, nullptr, &timer);
+    double baseNs = nsPerOp(kSamples, advance);
+    cancel_repeating_timer(&timer);
+
+    service.encoder_start();
+    double ns = nsPerOp(kSamples, advance);
+    return std::max(ns - baseNs, 0.0);
+}
+
+/***************************************************************
+ * Controller
+ ****************************************************************/
+static void benchPid() {
+    static float measurements[4096];
+    float rpm = 0.0f;
+    unsigned seed = 12345;
+    for (int i = 0; i < 4096; i++) {
+        rpm += (120.0f - rpm) * 0.05f;
+        seed = seed * 1103515245u + 12345u;
+        measurements[i] = rpm + ((seed >> 16) % 200) * 0.01f - 1.0f;
+    }
+
+    // Shipped defaults (PID_config.hpp) at the service sample period
+    MotorPID::PIDINPUT in = {MOTOR_PID_KP, MOTOR_PID_KI, MOTOR_PID_KD, ENCODER_SAMPLE_PERIOD_MS / 1000.0f, 120.0f,
+                             MOTOR_PID_KFF, MOTOR_PID_D_FILTER_TAU, MOTOR_PID_KAW, MOTOR_PID_SLEW_RATE};
+    MotorPID pid(&in);
+
+    bench("pid_compute_ns", nsPerOp(kSteps, [&](long n) {
+        float acc = 0.0f;
+        for (long i = 0; i < n; i++) acc += pid.ComputePID(measurements[i & 4095]).total;
+        sink = acc;
+    }), "ns/op");
+
+    bench("pid_update_throttle_ns", nsPerOp(kSteps, [&](long n) {
+        float acc = 0.0f;
+        for (long i = 0; i < n; i++) acc += pid.UpdateThrottle(measurements[i & 4095]);
+        sink = acc;
+    }), "ns/op");
+}
+
+/***************************************************************
+ * Profiler overhead
+ * Description:
+ *     - Cost one PROFILE_ZONE adds to the code it wraps; the
+ *       ENCODER_ISR figure is paid on every edge IRQ.
+ ****************************************************************/
+#if CPU_PROFILER_ENABLE
+static void benchProfiler() {
+    static const char* const kZoneNames[CPU_PROFILER_ZONES] = {
+        "encoder_isr", "timer_callback", "control_loop", "telemetry_io", "idle", "other",
+    };
+    for (int z = 0; z < CPU_PROFILER_ZONES; z++) {
+        ProfileZone zone = static_cast<ProfileZone>(z);
+        bench(std::string("profile_zone_ns_") + kZoneNames[z], nsPerOp(kSteps, [&](long n) {
+            for (long i = 0; i < n; i++) {
+                CpuProfileScope scope(zone);
+            }
+        }), "ns/op");
+    }
+}
+#endif
+
+/***************************************************************
+ * Quadrature correctness
+ * Description:
+ *     - Runs through the normal IRQ path (sim::setPins) with the
+ *       default glitch filter and realistic edge spacing.
+ *     - Counters are compared as deltas: encoders are registered
+ *       once per process and keep their totals.
+ ****************************************************************/
+struct Snapshot {
+    int32_t ticks;
+    uint32_t edges, errors, glitches;
+    explicit Snapshot(const EncoderHAL& e)
+        : ticks(e.encoder_getTicks()), edges(e.encoder_getEdgeCount()),
+          errors(e.encoder_getErrorCount()), glitches(e.encoder_getGlitchCount()) {}
+};
+
+static unsigned lcg(unsigned& seed) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 16;
+}
+
+static void testQuadrature(EncoderHAL* enc[], QuadratureGen* gen[]) {
+    const int kCount = 20000;
+    unsigned seed = 7;
+
+    {   // Forward
+        Snapshot s(*enc[0]);
+        int32_t start = gen[0]->position();
+        for (int i = 0; i < kCount; i++) { sim::advanceUs(100); gen[0]->step(1); }
+        test("decode_forward", enc[0]->encoder_getTicks() - s.ticks == gen[0]->position() - start &&
+                               enc[0]->encoder_getEdgeCount() - s.edges == static_cast<uint32_t>(kCount) &&
+                               enc[0]->encoder_getErrorCount() == s.errors &&
+                               enc[0]->encoder_getDirection() == EncoderDirection::FORWARD);
+    }
+    {   // Reverse
+        Snapshot s(*enc[0]);
+        for (int i = 0; i < kCount; i++) { sim::advanceUs(100); gen[0]->step(-1); }
+        test("decode_reverse", enc[0]->encoder_getTicks() - s.ticks == -kCount &&
+                               enc[0]->encoder_getErrorCount() == s.errors &&
+                               enc[0]->encoder_getDirection() == EncoderDirection::BACKWARD);
+    }
+    {   // Jitter: dithering across edges at uneven spacing above the filter
+        Snapshot s(*enc[0]);
+        int32_t start = gen[0]->position();
+        int dir = 1;
+        for (int i = 0; i < kCount; i++) {
+            if (lcg(seed) % 100 < 30) dir = -dir;
+            sim::advanceUs(ENCODER_MIN_EDGE_INTERVAL_US + 5 + lcg(seed) % 200);
+            gen[0]->step(dir);
+        }
+        test("decode_jitter", enc[0]->encoder_getTicks() - s.ticks == gen[0]->position() - start &&
+                              enc[0]->encoder_getErrorCount() == s.errors &&
+                              enc[0]->encoder_getGlitchCount() == s.glitches);
+    }
+    {   // Missed edges: every skipped state is one error and no count
+        Snapshot s(*enc[0]);
+        int32_t start = gen[0]->position();
+        int missed = 0;
+        for (int i = 0; i < kCount; i++) {
+            sim::advanceUs(100);
+            if (i % 50 == 25) {
+                gen[0]->skip(1);
+                missed++;
+            } else {
+                gen[0]->step(1);
+            }
+        }
+        test("decode_missed_edges", enc[0]->encoder_getErrorCount() - s.errors == static_cast<uint32_t>(missed) &&
+                                    enc[0]->encoder_getTicks() - s.ticks == gen[0]->position() - start - 2 * missed);
+    }
+    if (ENCODER_MAX_INSTANCES >= 2) {   // Interleaved: each edge reaches its own encoder only
+        Snapshot s0(*enc[0]), s1(*enc[1]);
+        for (int i = 0; i < kCount; i++) {
+            sim::advanceUs(50);
+            gen[i & 1]->step((i & 1) ? -1 : 1);
+        }
+        test("decode_interleaved", enc[0]->encoder_getTicks() - s0.ticks == kCount / 2 &&
+                                   enc[1]->encoder_getTicks() - s1.ticks == -kCount / 2 &&
+                                   enc[0]->encoder_getErrorCount() == s0.errors &&
+                                   enc[1]->encoder_getErrorCount() == s1.errors);
+    }
+}
+
+/***************************************************************
+ * Output
+ ****************************************************************/
+static void writeJson(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return;
+    }
+    fprintf(f, "{\n  \"suite\": \"encoder_control\",\n");
+    fprintf(f, "  \"config\": {\"encoders\": %d, \"pid_form\": \"%s\", \"profiler\": %d},\n",
+            ENCODER_MAX_INSTANCES,
+            PID_CONTROLLER_FORM == PID_FORM_POSITIONAL ? "positional" : "incremental",
+            CPU_PROFILER_ENABLE);
+    fprintf(f, "  \"pass\": %s,\n  \"results\": [\n", allPassed ? "true" : "false");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        fprintf(f, "    {\"kind\": \"%s\", \"name\": \"%s\", \"value\": %.4f, \"unit\": \"%s\"}%s\n",
+                r.kind.c_str(), r.name.c_str(), r.value, r.unit, (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+}
+
+static void writeCsv(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return;
+    }
+    fprintf(f, "kind,name,value,unit\n");
+    for (const Result& r : results) {
+        fprintf(f, "%s,%s,%.4f,%s\n", r.kind.c_str(), r.name.c_str(), r.value, r.unit);
+    }
+    fclose(f);
+}
+
+// Slowdown of each benchmark against a previous CSV: positive is worse.
+// Returns false if one exceeds maxSlowdown (< 0: report only).
+static bool compareBaseline(const char* path, double maxSlowdown) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "cannot read baseline %s\n", path);
+        return maxSlowdown < 0.0;
+    }
+    printf("\nAgainst %s:\n", path);
+    bool within = true;
+    char line[256], kind[16], name[96], unit[32];
+    double value;
+    while (fgets(line, sizeof line, f)) {
+        if (sscanf(line, "%15[^,],%95[^,],%lf,%31s", kind, name, &value, unit) != 4 ||
+            strcmp(kind, "bench") != 0 || value <= 0.0) {
+            continue;
+        }
+        for (const Result& r : results) {
+            if (r.kind != "bench" || r.name != name) continue;
+            bool rate = strstr(r.unit, "/s") != nullptr;    // Higher is better
+            double slowdown = rate ? value / r.value - 1.0 : r.value / value - 1.0;
+            bool regressed = maxSlowdown >= 0.0 && slowdown > maxSlowdown;
+            printf("  %-34s %+8.1f %%%s\n", name, slowdown * 100.0, regressed ? "  REGRESSION" : "");
+            within &= !regressed;
+        }
+    }
+    fclose(f);
+    return within;
+}
+
+int main(int argc, char** argv) {
+    const char* jsonPath = nullptr;
+    const char* csvPath = nullptr;
+    const char* baselinePath = nullptr;
+    double maxSlowdown = -1.0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+        else if (!strcmp(argv[i], "--csv") && i + 1 < argc) csvPath = argv[++i];
+        else if (!strcmp(argv[i], "--baseline") && i + 1 < argc) baselinePath = argv[++i];
+        else if (!strcmp(argv[i], "--max-slowdown") && i + 1 < argc) maxSlowdown = atof(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--json file] [--csv file] [--baseline file.csv [--max-slowdown f]]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    sim::reset();
+
+    // Encoders register for dispatch on construction: measure each
+    // count before adding the next one
+    printf("Decode and dispatch:\n");
+    EncoderHAL* enc[ENCODER_MAX_INSTANCES];
+    QuadratureGen* gen[ENCODER_MAX_INSTANCES];
+    for (int n = 0; n < ENCODER_MAX_INSTANCES; n++) {
+        enc[n] = new EncoderHAL(kPins[n][0], kPins[n][1]);
+        enc[n]->encoder_init();
+        enc[n]->encoder_setGlitchFilter(0);
+        gen[n] = new QuadratureGen(kPins[n][0], kPins[n][1]);
+
+        for (int target = 0; target <= n; target++) {
+            double ns = dispatchNs(target, *gen[target], pinWriteNs(*gen[target]));
+            std::string suffix = "_n" + std::to_string(n + 1) + "_enc" + std::to_string(target + 1);
+            bench("dispatch_ns" + suffix, ns, "ns/edge");
+            if (n == ENCODER_MAX_INSTANCES - 1 && target == n) {
+                bench("decode_edges_per_s", ns > 0.0 ? 1e9 / ns : 0.0, "edges/s");
+            }
+        }
+    }
+
+    // Back to the shipped filter and a known pin state for the tests
+    for (int n = 0; n < ENCODER_MAX_INSTANCES; n++) {
+        sim::advanceUs(1000);
+        gen[n]->apply();
+        enc[n]->encoder_setGlitchFilter(ENCODER_MIN_EDGE_INTERVAL_US);
+    }
+
+    printf("\nService and controller:\n");
+    EncoderService service(*enc[0]);
+    bench("service_tick_ns", serviceTickNs(service), "ns/op");
+    benchPid();
+#if CPU_PROFILER_ENABLE
+    printf("\nProfiler:\n");
+    benchProfiler();
+#endif
+
+    printf("\nQuadrature decode:\n");
+    testQuadrature(enc, gen);
+
+    if (jsonPath) writeJson(jsonPath);
+    if (csvPath) writeCsv(csvPath);
+    bool within = baselinePath ? compareBaseline(baselinePath, maxSlowdown) : true;
+
+    printf("\n%s\n", allPassed && within ? "PASS" : "FAIL");
+    return allPassed && within ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#ifndef FILE_STORAGE_HPP
+#define FILE_STORAGE_HPP
+
+/***************************************************************
+ * File-backed NvStorage (host)
+ * Description:
+ *     - A file the size of the region stands in for the reserved
+ *       flash sectors. Erase fills 0xFF, program ANDs data into
+ *       the image (it can only clear bits), like NOR flash.
+ *     - Every write goes through to the file, so a new instance
+ *       on the same path sees what a reboot would see.
+ *     - cutPowerAfter(n) lets only the next n bytes of programming
+ *       or erasing reach the medium, then fails every write:
+ *       a power cut in the middle of a save.
+ ****************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "Flash/nv_storage.hpp"
+
+class FileStorage : public NvStorage {
+public:
+    FileStorage(const char* path, uint32_t size, uint32_t eraseSize)
+        : _path(path), _image(size, 0xFF), _eraseSize(eraseSize),
+          _budget(-1), _erases(size / eraseSize, 0) {
+        FILE* f = std::fopen(_path, "rb");
+        if (f) {
+            size_t n = std::fread(_image.data(), 1, _image.size(), f);
+            (void)n;
+            std::fclose(f);
+        }
+        flush();
+    }
+
+    uint32_t nv_size() const override { return static_cast<uint32_t>(_image.size()); }
+    uint32_t nv_eraseSize() const override { return _eraseSize; }
+
+    bool nv_read(uint32_t offset, void* dst, uint32_t length) override {
+        if (!inRange(offset, length)) return false;
+        std::memcpy(dst, &_image[offset], length);
+        return true;
+    }
+
+    bool nv_erase(uint32_t offset, uint32_t length) override {
+        if (!inRange(offset, length) || offset % _eraseSize || length % _eraseSize) return false;
+        for (uint32_t b = offset / _eraseSize; b < (offset + length) / _eraseSize; b++) _erases[b]++;
+        bool complete = true;
+        for (uint32_t i = 0; i < length; i++) {
+            if (!spend()) { complete = false; break; }
+            _image[offset + i] = 0xFF;
+        }
+        flush();
+        return complete;
+    }
+
+    bool nv_program(uint32_t offset, const void* src, uint32_t length) override {
+        if (!inRange(offset, length) || offset % 256 || length % 256) return false;
+        const uint8_t* p = static_cast<const uint8_t*>(src);
+        bool complete = true;
+        for (uint32_t i = 0; i < length; i++) {
+            if (!spend()) { complete = false; break; }
+            _image[offset + i] &= p[i];
+        }
+        flush();
+        return complete;
+    }
+
+    void cutPowerAfter(long bytes) { _budget = bytes; }
+    void restorePower() { _budget = -1; }
+    uint32_t eraseCount(uint32_t block) const { return _erases[block]; }
+    uint8_t* image() { return _image.data(); }
+    void flush() {
+        FILE* f = std::fopen(_path, "wb");
+        if (f) {
+            std::fwrite(_image.data(), 1, _image.size(), f);
+            std::fclose(f);
+        }
+    }
+
+private:
+    bool inRange(uint32_t offset, uint32_t length) const {
+        return offset <= _image.size() && length <= _image.size() - offset;
+    }
+    bool spend() {
+        if (_budget < 0) return true;
+        if (_budget == 0) return false;
+        _budget--;
+        return true;
+    }
+
+    const char* _path;
+    std::vector<uint8_t> _image;
+    uint32_t _eraseSize;
+    long _budget;                   // Bytes left before the power cut, -1 = none
+    std::vector<uint32_t> _erases;  // Erase count per block
+};
+
+#endif // FILE_STORAGE_HPP
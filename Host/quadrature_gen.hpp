@@ -0,0 +1,64 @@
+#ifndef QUADRATURE_GEN_HPP
+#define QUADRATURE_GEN_HPP
+
+/***************************************************************
+ * Quadrature Waveform Generator (host)
+ * Description:
+ *     - Steps a simulated encoder through the Gray sequence and
+ *       drives its A/B pins through the simulated GPIO.
+ *     - Forward (A leads B): 0 -> 2 -> 3 -> 1 -> 0, state = (A << 1) | B.
+ *     - Both pins are written in one sim::setPins() call, so a
+ *       skip() changes them atomically, as a missed edge looks to
+ *       the decoder.
+ ****************************************************************/
+
+#include "sim.hpp"
+
+class QuadratureGen {
+public:
+    QuadratureGen(uint pinA, uint pinB) : _pinA(pinA), _pinB(pinB), _phase(0), _position(0) {
+        apply();
+    }
+
+    // One edge forward (+1) or backward (-1)
+    void step(int dir) {
+        advance(dir);
+        apply();
+    }
+
+    // One edge without driving the pins, for callers that write
+    // their own levels (e.g. a simulated wiring fault)
+    void advance(int dir) {
+        _phase = (_phase + (dir > 0 ? 1 : 3)) & 3;
+        _position += (dir > 0) ? 1 : -1;
+    }
+
+    // Two edges in one pin change: an edge the decoder never saw
+    void skip(int dir) {
+        _phase = (_phase + 2) & 3;
+        _position += (dir > 0) ? 2 : -2;
+        apply();
+    }
+
+    // Re-drives the current state, after the pins were set directly
+    void apply() { sim::setPins(mask(), levels(_phase)); }
+
+    // Pin word of a phase, for callers driving sim::setPins themselves
+    uint32_t mask() const { return (1u << _pinA) | (1u << _pinB); }
+    uint32_t levels(int phase) const {
+        uint8_t s = kSequence[phase & 3];
+        return (((s >> 1) & 1u) << _pinA) | ((s & 1u) << _pinB);
+    }
+
+    int32_t position() const { return _position; }
+    uint8_t state() const { return kSequence[_phase]; }
+
+private:
+    static constexpr uint8_t kSequence[4] = {0, 2, 3, 1};
+
+    uint _pinA, _pinB;
+    int _phase;
+    int32_t _position;
+};
+
+#endif // QUADRATURE_GEN_HPP
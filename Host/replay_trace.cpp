@@ -0,0 +1,216 @@
+/***************************************************************
+ *  File: replay_trace.cpp
+ *  Description:
+ *      - Replays an EncoderTrace dump through the real EncoderHAL
+ *        decode and EncoderService::update on the simulated clock.
+ *      - Reports counts, decode errors, glitches and the RPM
+ *        series, and optionally the replay throughput.
+ *
+ *  Usage:
+ *      replay_trace <dump file> [--series] [--bench N]
+ *                   [--expect ticks1[,ticks2]]
+ *
+ *      The dump may be a raw serial log; everything outside the
+ *      QETRACE ... QETRACE END block is ignored.
+ ****************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "sim.hpp"
+#include "Encoder/encoder_hal.hpp"
+#include "Encoder/encoder_service.hpp"
+#include "Encoder/encoder_trace.hpp"
+
+static const uint kPins[ENCODER_MAX_INSTANCES][2] = {
+    {ENCODER1_PIN_A, ENCODER1_PIN_B},
+    {ENCODER2_PIN_A, ENCODER2_PIN_B},
+};
+static const uint64_t kStartUs = 1000;          // Replay clock at trace start
+static const uint64_t kSamplePeriodUs = ENCODER_SAMPLE_PERIOD_MS * 1000ull;
+
+struct Trace {
+    uint32_t startUs;
+    int encoders;
+    uint8_t startState[ENCODER_MAX_INSTANCES];
+    std::vector<uint32_t> words;
+};
+
+/***************************************************************
+ * Function: loadTrace
+ ****************************************************************/
+static bool loadTrace(FILE* f, Trace& trace) {
+    char line[256];
+    unsigned version = 0, encoders = 0;
+    unsigned long count = 0, startUs = 0;
+
+    while (fgets(line, sizeof line, f)) {
+        int offset = 0;
+        if (sscanf(line, "QETRACE %u %lu %lu %u%n", &version, &count, &startUs, &encoders, &offset) == 4) {
+            break;
+        }
+    }
+    if (version != TRACE_VERSION || encoders == 0 || encoders > ENCODER_MAX_INSTANCES) {
+        fprintf(stderr, "no supported QETRACE block found\n");
+        return false;
+    }
+
+    // Start states follow the header fields
+    char* p = strstr(line, "QETRACE") + 7;
+    for (int field = 0; field < 4; field++) strtoul(p, &p, 10);
+    trace.startUs = static_cast<uint32_t>(startUs);
+    trace.encoders = static_cast<int>(encoders);
+    for (int i = 0; i < trace.encoders; i++) {
+        trace.startState[i] = static_cast<uint8_t>(strtoul(p, &p, 10) & 3u);
+    }
+
+    trace.words.reserve(count);
+    unsigned long word;
+    while (trace.words.size() < count && fscanf(f, "%lx", &word) == 1) {
+        trace.words.push_back(static_cast<uint32_t>(word));
+    }
+    if (trace.words.size() != count) {
+        fprintf(stderr, "trace truncated: %zu of %lu records\n", trace.words.size(), count);
+        return false;
+    }
+    return true;
+}
+
+static void drivePins(int encoder, uint8_t state) {
+    uint32_t mask = (1u << kPins[encoder][0]) | (1u << kPins[encoder][1]);
+    uint32_t levels = (((state >> 1) & 1u) << kPins[encoder][0]) | ((state & 1u) << kPins[encoder][1]);
+    sim::setPins(mask, levels);
+}
+
+/***************************************************************
+ * Class: Replay
+ * Description:
+ *     - Owns the simulated encoders and services. EncoderHAL
+ *       instances register globally, so they are created once
+ *       and re-initialized for each run.
+ ****************************************************************/
+class Replay {
+public:
+    Replay(int encoders) : _encoders(encoders) {
+        for (int i = 0; i < encoders; i++) {
+            _hal[i] = new EncoderHAL(kPins[i][0], kPins[i][1]);
+            _service[i] = new EncoderService(*_hal[i]);
+        }
+    }
+
+    // Returns the number of A/B changes fed to the decoder
+    uint64_t run(const Trace& trace, bool printSeries) {
+        sim::reset();
+        for (int i = 0; i < _encoders; i++) drivePins(i, trace.startState[i]);
+        sim::advanceTo(kStartUs);
+        for (int i = 0; i < _encoders; i++) {
+            _hal[i]->encoder_init();
+            _hal[i]->encoder_clear();
+            _service[i]->encoder_start();
+        }
+
+        if (printSeries) {
+            printf("t_ms");
+            for (int i = 0; i < _encoders; i++) printf(",rpm%d", i + 1);
+            printf("\n");
+        }
+
+        uint64_t t = kStartUs;
+        uint64_t nextSample = kStartUs + kSamplePeriodUs;
+        uint64_t changes = 0;
+
+        for (size_t r = 0; r <= trace.words.size(); r++) {
+            bool last = (r == trace.words.size());
+            uint32_t w = last ? 0 : trace.words[r];
+            t += last ? kSamplePeriodUs : traceDelta(w);
+
+            while (nextSample <= t) {
+                sim::advanceTo(nextSample);
+                if (printSeries) series(nextSample);
+                nextSample += kSamplePeriodUs;
+            }
+            sim::advanceTo(t);
+
+            if (!last && traceEncoder(w) != TRACE_INDEX_GAP && traceEncoder(w) < (uint32_t)_encoders) {
+                drivePins(traceEncoder(w), traceState(w));
+                changes++;
+            }
+        }
+        return changes;
+    }
+
+    EncoderHAL& hal(int i) { return *_hal[i]; }
+
+private:
+    void series(uint64_t t) {
+        printf("%.0f", (t - kStartUs) / 1000.0);
+        for (int i = 0; i < _encoders; i++) printf(",%.2f", _service[i]->encoder_getRPM());
+        printf("\n");
+    }
+
+    int _encoders;
+    EncoderHAL* _hal[ENCODER_MAX_INSTANCES];
+    EncoderService* _service[ENCODER_MAX_INSTANCES];
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <dump> [--series] [--bench N] [--expect t1[,t2]]\n", argv[0]);
+        return 2;
+    }
+
+    bool printSeries = false;
+    int benchRuns = 0;
+    const char* expect = nullptr;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--series")) printSeries = true;
+        else if (!strcmp(argv[i], "--bench") && i + 1 < argc) benchRuns = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--expect") && i + 1 < argc) expect = argv[++i];
+    }
+
+    FILE* f = fopen(argv[1], "r");
+    if (!f) {
+        perror(argv[1]);
+        return 2;
+    }
+    Trace trace;
+    bool loaded = loadTrace(f, trace);
+    fclose(f);
+    if (!loaded) return 2;
+
+    Replay replay(trace.encoders);
+    uint64_t changes = replay.run(trace, printSeries);
+
+    bool ok = true;
+    const char* e = expect;
+    for (int i = 0; i < trace.encoders; i++) {
+        EncoderHAL& hal = replay.hal(i);
+        printf("encoder%d ticks=%ld edges=%lu errors=%lu glitches=%lu storms=%lu\n", i + 1,
+               (long)hal.encoder_getTicks(), (unsigned long)hal.encoder_getEdgeCount(),
+               (unsigned long)hal.encoder_getErrorCount(), (unsigned long)hal.encoder_getGlitchCount(),
+               (unsigned long)hal.encoder_getStormCount());
+
+        if (e && *e) {
+            char* end;
+            long want = strtol(e, &end, 10);
+            if (want != hal.encoder_getTicks()) {
+                printf("FAIL: encoder%d expected %ld ticks\n", i + 1, want);
+                ok = false;
+            }
+            e = (*end == ',') ? end + 1 : end;
+        }
+    }
+
+    if (benchRuns > 0) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < benchRuns; r++) replay.run(trace, false);
+        auto t1 = std::chrono::steady_clock::now();
+        double s = std::chrono::duration<double>(t1 - t0).count();
+        printf("replay: %llu edges x %d runs in %.3f s = %.0f edges/s\n",
+               (unsigned long long)changes, benchRuns, s, changes * benchRuns / s);
+    }
+
+    return ok ? 0 : 1;
+}
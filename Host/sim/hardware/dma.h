@@ -0,0 +1,57 @@
+#ifndef SIM_HARDWARE_DMA_H
+#define SIM_HARDWARE_DMA_H
+
+#include "pico.h"
+
+/***************************************************************
+ * DMA model
+ * Description:
+ *     - Channels move one word per DREQ from the PIO sampler into
+ *       memory, with write increment, write-address ring,
+ *       chaining and the IRQ0 status/enable bits.
+ *     - As on the hardware, a channel keeps its write address
+ *       after it completes; a re-trigger continues from there
+ *       unless a ring wraps it.
+ ****************************************************************/
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2,
+};
+
+typedef struct {
+    enum dma_channel_transfer_size size;
+    bool readIncrement;
+    bool writeIncrement;
+    uint dreq;
+    uint chainTo;               // Own channel number = no chaining
+    bool ringWrite;
+    uint ringBits;              // 0 = no ring
+} dma_channel_config;
+
+dma_channel_config dma_channel_get_default_config(uint channel);
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c,
+                                                         enum dma_channel_transfer_size size) {
+    c->size = size;
+}
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr) { c->readIncrement = incr; }
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr) { c->writeIncrement = incr; }
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq) { c->dreq = dreq; }
+static inline void channel_config_set_chain_to(dma_channel_config *c, uint chain_to) { c->chainTo = chain_to; }
+static inline void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits) {
+    c->ringWrite = write;
+    c->ringBits = size_bits;
+}
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger);
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger);
+void dma_channel_start(uint channel);
+bool dma_channel_is_busy(uint channel);
+void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+bool dma_channel_get_irq0_status(uint channel);
+void dma_channel_acknowledge_irq0(uint channel);
+
+#endif // SIM_HARDWARE_DMA_H
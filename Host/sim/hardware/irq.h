@@ -0,0 +1,17 @@
+#ifndef SIM_HARDWARE_IRQ_H
+#define SIM_HARDWARE_IRQ_H
+
+#include "pico.h"
+
+typedef void (*irq_handler_t)(void);
+
+// IRQ numbers as on the RP2040
+#define DMA_IRQ_0 11
+#define DMA_IRQ_1 12
+
+// A DMA IRQ raised while interrupts are disabled stays pending until
+// restore_interrupts() re-enables them, as on the hardware
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
+
+#endif // SIM_HARDWARE_IRQ_H
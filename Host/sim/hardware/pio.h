@@ -0,0 +1,58 @@
+#ifndef SIM_HARDWARE_PIO_H
+#define SIM_HARDWARE_PIO_H
+
+#include "pico.h"
+
+/***************************************************************
+ * PIO model
+ * Description:
+ *     - Only the GPIO sampler EncoderDMA loads is modelled: an
+ *       enabled state machine pushes gpio_get_all() into its RX
+ *       FIFO once per clock (clk_sys / clkdiv), where a DMA
+ *       channel paced by its DREQ takes it.
+ ****************************************************************/
+typedef struct {
+    volatile uint32_t rxf[4];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t sim_pio0;
+#define pio0 (&sim_pio0)
+
+struct pio_program {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+};
+
+typedef struct {
+    float clkdiv;
+} pio_sm_config;
+
+enum pio_fifo_join {
+    PIO_FIFO_JOIN_NONE = 0,
+    PIO_FIFO_JOIN_TX = 1,
+    PIO_FIFO_JOIN_RX = 2,
+};
+
+static inline pio_sm_config pio_get_default_sm_config(void) {
+    pio_sm_config c = {1.0f};
+    return c;
+}
+
+static inline void sm_config_set_wrap(pio_sm_config *, uint, uint) {}
+static inline void sm_config_set_in_pins(pio_sm_config *, uint) {}
+static inline void sm_config_set_in_shift(pio_sm_config *, bool, bool, uint) {}
+static inline void sm_config_set_fifo_join(pio_sm_config *, enum pio_fifo_join) {}
+static inline void sm_config_set_clkdiv(pio_sm_config *c, float div) { c->clkdiv = div; }
+
+// DREQ numbering as on the RP2040: PIO0 TX0..3 = 0..3, RX0..3 = 4..7
+static inline uint pio_get_dreq(PIO, uint sm, bool is_tx) { return (is_tx ? 0u : 4u) + sm; }
+
+uint pio_add_program(PIO pio, const struct pio_program *program);
+int pio_claim_unused_sm(PIO pio, bool required);
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+
+#endif // SIM_HARDWARE_PIO_H
@@ -0,0 +1,14 @@
+#ifndef SIM_HARDWARE_SYNC_H
+#define SIM_HARDWARE_SYNC_H
+
+#include "pico.h"
+
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+static inline void __dmb(void) {}
+static inline void __sev(void) {}
+static inline void __wfe(void) {}
+static inline uint get_core_num(void) { return 0; }
+
+#endif // SIM_HARDWARE_SYNC_H
@@ -0,0 +1,21 @@
+#ifndef SIM_PICO_H
+#define SIM_PICO_H
+
+/***************************************************************
+ * Host simulation of the Pico SDK (base types)
+ * Description:
+ *     - Provides the subset of the SDK used by the HAL and Service
+ *       layers so they compile and run unchanged on Linux.
+ *     - Time and GPIO are virtual; see sim.hpp for the controls.
+ ****************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define PICO_ERROR_TIMEOUT -1
+
+#endif // SIM_PICO_H
@@ -0,0 +1,14 @@
+#ifndef SIM_PICO_STDLIB_H
+#define SIM_PICO_STDLIB_H
+
+#include "pico.h"
+#include "hardware/gpio.h"
+#include "hardware/timer.h"
+
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+#endif // SIM_PICO_STDLIB_H
@@ -0,0 +1,519 @@
+/***************************************************************
+ *  File: sim.cpp
+ *  Description:
+ *      - Single-threaded implementation of the simulated Pico SDK.
+ *      - All "interrupts" run synchronously from sim::advanceUs()
+ *        and sim::setPin(), so host runs are fully deterministic.
+ ****************************************************************/
+
+#include "sim.hpp"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/pwm.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include <cstring>
+#include <vector>
+#include <deque>
+
+namespace {
+
+const int kMaxPins = 32;
+const int kHardwareAlarms = 4;
+const int kPwmSlices = 8;
+const int kPioStateMachines = 4;
+const int kDmaChannels = 12;
+const uint32_t kSysClockHz = 125000000;
+
+struct Event {
+    uint64_t time;
+    int kind;                        // 0 = repeating timer, 1 = alarm, 2 = hardware alarm,
+                                     // 3 = PIO state machine clock
+    repeating_timer_t* timer;
+    alarm_id_t alarmId;
+    alarm_callback_t alarmCallback;
+    void* userData;
+    uint hardwareAlarm;
+    uint sm;
+};
+
+struct DmaChannel {
+    bool claimed;
+    dma_channel_config config;
+    uint8_t* write;                  // Next write address
+    uint count;                      // Transfer count, reloaded by each trigger
+    uint remaining;
+    bool busy;
+    bool irqEnabled;
+    bool irqStatus;
+};
+
+uint64_t now;
+uint32_t inputs;
+uint32_t outputs;
+uint16_t pwmLevels[kMaxPins];
+uint16_t pwmWraps[kPwmSlices];
+bool pwmEnabled[kPwmSlices];
+uint32_t irqMask[kMaxPins];
+gpio_irq_callback_t gpioCallback;
+int irqDisabled;
+alarm_id_t nextAlarmId;
+uint32_t alarmFailures;
+bool alarmClaimed[kHardwareAlarms];
+hardware_alarm_callback_t alarmCallbacks[kHardwareAlarms];
+std::vector<Event> events;
+std::deque<char> input;
+bool smClaimed[kPioStateMachines];
+uint64_t smPeriodUs[kPioStateMachines];
+DmaChannel dmaChannels[kDmaChannels];
+irq_handler_t dmaIrqHandler;
+bool dmaIrqEnabled;
+bool dmaIrqPending;
+
+// DMA_IRQ_0 is taken at once, or held pending while interrupts are off
+void raiseDmaIrq() {
+    if (!dmaIrqEnabled || !dmaIrqHandler) return;
+    if (irqDisabled) {
+        dmaIrqPending = true;
+    } else {
+        dmaIrqHandler();
+    }
+}
+
+void dmaTrigger(uint channel) {
+    DmaChannel& ch = dmaChannels[channel];
+    ch.remaining = ch.count;
+    ch.busy = ch.count > 0;
+}
+
+void dmaComplete(uint channel) {
+    DmaChannel& ch = dmaChannels[channel];
+    ch.busy = false;
+    ch.irqStatus = true;
+    if (ch.config.chainTo != channel) dmaTrigger(ch.config.chainTo);
+    if (ch.irqEnabled) raiseDmaIrq();
+}
+
+// One word into a channel, with write increment and address ring
+void dmaTransfer(uint channel, uint32_t word) {
+    DmaChannel& ch = dmaChannels[channel];
+    uintptr_t bytes = 1u << ch.config.size;
+    std::memcpy(ch.write, &word, bytes);
+
+    if (ch.config.writeIncrement) {
+        uintptr_t addr = reinterpret_cast<uintptr_t>(ch.write);
+        uintptr_t next = addr + bytes;
+        if (ch.config.ringWrite && ch.config.ringBits) {
+            uintptr_t ring = (static_cast<uintptr_t>(1) << ch.config.ringBits) - 1;
+            next = (addr & ~ring) | (next & ring);
+        }
+        ch.write = reinterpret_cast<uint8_t*>(next);
+    }
+    if (--ch.remaining == 0) dmaComplete(channel);
+}
+
+// The sampler's "in pins, 32": one GPIO snapshot per clock, taken
+// by the busy channel paced by its RX DREQ, dropped if there is none
+void pioSample(uint sm) {
+    uint32_t sample = inputs;
+    sim_pio0.rxf[sm] = sample;
+    uint dreq = pio_get_dreq(pio0, sm, false);
+    for (uint c = 0; c < kDmaChannels; c++) {
+        if (dmaChannels[c].busy && dmaChannels[c].config.dreq == dreq) {
+            dmaTransfer(c, sample);
+            return;
+        }
+    }
+}
+
+// Index of the earliest event due at or before 'limit', or -1
+int nextDue(uint64_t limit) {
+    int best = -1;
+    for (size_t i = 0; i < events.size(); i++) {
+        if (events[i].time <= limit && (best < 0 || events[i].time < events[best].time)) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+void fire(Event ev) {
+    if (ev.time > now) now = ev.time;      // Late after a stall
+    if (ev.kind == 0) {
+        repeating_timer_t* t = ev.timer;
+        if (t->callback(t)) {
+            uint64_t delay = t->delay_us < 0 ? -t->delay_us : t->delay_us;
+            ev.time = (t->delay_us < 0 ? ev.time : now) + delay;
+            events.push_back(ev);
+        }
+    } else if (ev.kind == 1) {
+        int64_t again = ev.alarmCallback(ev.alarmId, ev.userData);
+        if (again != 0) {
+            ev.time = (again < 0) ? ev.time - again : now + again;
+            events.push_back(ev);
+        }
+    } else if (ev.kind == 2) {
+        alarmCallbacks[ev.hardwareAlarm](ev.hardwareAlarm);
+    } else {
+        pioSample(ev.sm);
+        ev.time += smPeriodUs[ev.sm];
+        events.push_back(ev);
+    }
+}
+
+void removeWhere(int kind, const void* timer, alarm_id_t id, uint hw) {
+    for (size_t i = 0; i < events.size(); i++) {
+        const Event& e = events[i];
+        bool match = (e.kind == kind) &&
+                     ((kind == 0 && e.timer == timer) ||
+                      (kind == 1 && e.alarmId == id) ||
+                      (kind == 2 && e.hardwareAlarm == hw) ||
+                      (kind == 3 && e.sm == hw));
+        if (match) {
+            events.erase(events.begin() + i);
+            return;
+        }
+    }
+}
+
+} // namespace
+
+/***************************************************************
+ * Simulation controls
+ ****************************************************************/
+namespace sim {
+
+void reset() {
+    now = 0;
+    inputs = 0;
+    outputs = 0;
+    for (int i = 0; i < kMaxPins; i++) {
+        irqMask[i] = 0;
+        pwmLevels[i] = 0;
+    }
+    for (int i = 0; i < kPwmSlices; i++) {
+        pwmWraps[i] = 0xFFFFu;
+        pwmEnabled[i] = false;
+    }
+    gpioCallback = nullptr;
+    irqDisabled = 0;
+    nextAlarmId = 1;
+    alarmFailures = 0;
+    for (int i = 0; i < kHardwareAlarms; i++) {
+        alarmClaimed[i] = false;
+        alarmCallbacks[i] = nullptr;
+    }
+    for (int i = 0; i < kPioStateMachines; i++) {
+        smClaimed[i] = false;
+        smPeriodUs[i] = 1;
+        sim_pio0.rxf[i] = 0;
+    }
+    for (int i = 0; i < kDmaChannels; i++) {
+        dmaChannels[i] = DmaChannel();
+    }
+    dmaIrqHandler = nullptr;
+    dmaIrqEnabled = false;
+    dmaIrqPending = false;
+    events.clear();
+    input.clear();
+}
+
+uint64_t nowUs() { return now; }
+
+void advanceTo(uint64_t timeUs) {
+    int i;
+    while ((i = nextDue(timeUs)) >= 0) {
+        Event ev = events[i];
+        events.erase(events.begin() + i);
+        fire(ev);
+    }
+    if (timeUs > now) now = timeUs;
+}
+
+void advanceUs(uint64_t us) { advanceTo(now + us); }
+
+void stallUs(uint64_t us) { now += us; }
+
+void setPins(uint32_t mask, uint32_t levels) {
+    uint32_t changed = (inputs ^ levels) & mask;
+    inputs = (inputs & ~mask) | (levels & mask);
+
+    for (uint pin = 0; pin < kMaxPins; pin++) {
+        if (!(changed & (1u << pin))) continue;
+
+        uint32_t event = ((inputs >> pin) & 1u) ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+        if ((irqMask[pin] & event) && gpioCallback && !irqDisabled) {
+            gpioCallback(pin, event);
+        }
+    }
+}
+
+void setPin(uint pin, bool level) {
+    setPins(1u << pin, level ? (1u << pin) : 0u);
+}
+
+gpio_irq_callback_t gpioIrqCallback() { return gpioCallback; }
+
+bool outputLevel(uint pin) { return (outputs >> pin) & 1u; }
+
+float pwmDuty(uint pin) {
+    uint slice = pwm_gpio_to_slice_num(pin);
+    if (!pwmEnabled[slice]) return 0.0f;
+    uint32_t top = pwmWraps[slice] + 1u;
+    return (pwmLevels[pin] >= top) ? 1.0f : static_cast<float>(pwmLevels[pin]) / top;
+}
+
+void failAlarms(uint32_t count) { alarmFailures = count; }
+
+void pushInput(const char* text) {
+    while (*text) input.push_back(*text++);
+}
+
+} // namespace sim
+
+/***************************************************************
+ * pico/stdlib
+ ****************************************************************/
+bool stdio_init_all(void) { return true; }
+
+int getchar_timeout_us(uint32_t) {
+    if (input.empty()) return PICO_ERROR_TIMEOUT;
+    char c = input.front();
+    input.pop_front();
+    return static_cast<unsigned char>(c);
+}
+
+void sleep_us(uint64_t us) { sim::advanceUs(us); }
+void sleep_ms(uint32_t ms) { sim::advanceUs(ms * 1000ull); }
+
+/***************************************************************
+ * hardware/gpio
+ ****************************************************************/
+void gpio_init(uint gpio) { irqMask[gpio] = 0; }
+void gpio_set_dir(uint, bool) {}
+void gpio_pull_up(uint) {}
+void gpio_set_function(uint, enum gpio_function) {}
+bool gpio_get(uint gpio) { return (inputs >> gpio) & 1u; }
+uint32_t gpio_get_all(void) { return inputs; }
+
+void gpio_put(uint gpio, bool value) {
+    if (value) outputs |= (1u << gpio);
+    else       outputs &= ~(1u << gpio);
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    // Like the SDK, pending edges are acknowledged before enabling
+    if (enabled) irqMask[gpio] |= event_mask;
+    else         irqMask[gpio] &= ~event_mask;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled,
+                                        gpio_irq_callback_t callback) {
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+    gpioCallback = callback;
+}
+
+void gpio_acknowledge_irq(uint, uint32_t) {}
+
+/***************************************************************
+ * hardware/sync
+ ****************************************************************/
+uint32_t save_and_disable_interrupts(void) { return static_cast<uint32_t>(irqDisabled++); }
+
+void restore_interrupts(uint32_t status) {
+    irqDisabled = static_cast<int>(status);
+    if (!irqDisabled && dmaIrqPending) {
+        dmaIrqPending = false;
+        raiseDmaIrq();
+    }
+}
+
+/***************************************************************
+ * hardware/timer
+ ****************************************************************/
+uint32_t time_us_32(void) { return static_cast<uint32_t>(now); }
+uint64_t time_us_64(void) { return now; }
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out) {
+    out->delay_us = delay_us;
+    out->pool = nullptr;
+    out->alarm_id = nextAlarmId++;
+    out->callback = callback;
+    out->user_data = user_data;
+
+    Event ev = {};
+    ev.kind = 0;
+    ev.timer = out;
+    ev.time = now + static_cast<uint64_t>(delay_us < 0 ? -delay_us : delay_us);
+    events.push_back(ev);
+    return true;
+}
+
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out) {
+    return add_repeating_timer_us(delay_ms * 1000ll, callback, user_data, out);
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer) {
+    size_t before = events.size();
+    removeWhere(0, timer, 0, 0);
+    return events.size() != before;
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool) {
+    if (alarmFailures > 0) {
+        alarmFailures--;
+        return -1;
+    }
+    Event ev = {};
+    ev.kind = 1;
+    ev.time = now + us;
+    ev.alarmId = nextAlarmId++;
+    ev.alarmCallback = callback;
+    ev.userData = user_data;
+    events.push_back(ev);
+    return ev.alarmId;
+}
+
+bool cancel_alarm(alarm_id_t alarm_id) {
+    size_t before = events.size();
+    removeWhere(1, nullptr, alarm_id, 0);
+    return events.size() != before;
+}
+
+int hardware_alarm_claim_unused(bool) {
+    for (int i = 0; i < kHardwareAlarms; i++) {
+        if (!alarmClaimed[i]) {
+            alarmClaimed[i] = true;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void hardware_alarm_unclaim(uint alarm_num) { alarmClaimed[alarm_num] = false; }
+
+void hardware_alarm_set_callback(uint alarm_num, hardware_alarm_callback_t callback) {
+    alarmCallbacks[alarm_num] = callback;
+}
+
+bool hardware_alarm_set_target(uint alarm_num, absolute_time_t t) {
+    removeWhere(2, nullptr, 0, alarm_num);
+    if (t <= now) return true;      // Missed, as reported by the SDK
+
+    Event ev = {};
+    ev.kind = 2;
+    ev.time = t;
+    ev.hardwareAlarm = alarm_num;
+    events.push_back(ev);
+    return false;
+}
+
+void hardware_alarm_cancel(uint alarm_num) { removeWhere(2, nullptr, 0, alarm_num); }
+
+/***************************************************************
+ * hardware/pwm
+ ****************************************************************/
+void pwm_set_wrap(uint slice_num, uint16_t wrap) { pwmWraps[slice_num] = wrap; }
+void pwm_set_enabled(uint slice_num, bool enabled) { pwmEnabled[slice_num] = enabled; }
+void pwm_set_gpio_level(uint gpio, uint16_t level) { pwmLevels[gpio] = level; }
+
+/***************************************************************
+ * hardware/clocks
+ ****************************************************************/
+uint32_t clock_get_hz(enum clock_index) { return kSysClockHz; }
+
+/***************************************************************
+ * hardware/pio
+ ****************************************************************/
+pio_hw_t sim_pio0;
+
+uint pio_add_program(PIO, const struct pio_program*) { return 0; }
+
+int pio_claim_unused_sm(PIO, bool) {
+    for (int i = 0; i < kPioStateMachines; i++) {
+        if (!smClaimed[i]) {
+            smClaimed[i] = true;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void pio_sm_init(PIO, uint sm, uint, const pio_sm_config* config) {
+    // One instruction per clock; the virtual clock resolves 1 us
+    uint64_t period = static_cast<uint64_t>(config->clkdiv * 1e6f / kSysClockHz + 0.5f);
+    smPeriodUs[sm] = period ? period : 1;
+}
+
+void pio_sm_set_enabled(PIO, uint sm, bool enabled) {
+    removeWhere(3, nullptr, 0, sm);
+    if (!enabled) return;
+
+    Event ev = {};
+    ev.kind = 3;
+    ev.time = now + smPeriodUs[sm];
+    ev.sm = sm;
+    events.push_back(ev);
+}
+
+/***************************************************************
+ * hardware/dma
+ ****************************************************************/
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    dma_channel_config c = {};
+    c.size = DMA_SIZE_32;
+    c.readIncrement = true;
+    c.writeIncrement = false;
+    c.dreq = 0x3f;                  // DREQ_FORCE: unpaced
+    c.chainTo = channel;
+    return c;
+}
+
+int dma_claim_unused_channel(bool) {
+    for (int i = 0; i < kDmaChannels; i++) {
+        if (!dmaChannels[i].claimed) {
+            dmaChannels[i].claimed = true;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config* config, volatile void* write_addr,
+                           const volatile void*, uint transfer_count, bool trigger) {
+    DmaChannel& ch = dmaChannels[channel];
+    ch.config = *config;
+    ch.write = static_cast<uint8_t*>(const_cast<void*>(write_addr));
+    ch.count = transfer_count;
+    if (trigger) dmaTrigger(channel);
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void* write_addr, bool trigger) {
+    dmaChannels[channel].write = static_cast<uint8_t*>(const_cast<void*>(write_addr));
+    if (trigger) dmaTrigger(channel);
+}
+
+void dma_channel_start(uint channel) { dmaTrigger(channel); }
+
+bool dma_channel_is_busy(uint channel) { return dmaChannels[channel].busy; }
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) { dmaChannels[channel].irqEnabled = enabled; }
+
+bool dma_channel_get_irq0_status(uint channel) { return dmaChannels[channel].irqStatus; }
+
+void dma_channel_acknowledge_irq0(uint channel) { dmaChannels[channel].irqStatus = false; }
+
+/***************************************************************
+ * hardware/irq
+ ****************************************************************/
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    if (num == DMA_IRQ_0) dmaIrqHandler = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    if (num == DMA_IRQ_0) dmaIrqEnabled = enabled;
+}
@@ -0,0 +1,61 @@
+#ifndef SIM_HPP
+#define SIM_HPP
+
+/***************************************************************
+ * Host simulation controls
+ * Description:
+ *     - Drives the virtual clock and GPIO inputs behind the
+ *       simulated Pico SDK.
+ *     - Timer and alarm callbacks fire in time order while the
+ *       clock advances; GPIO callbacks fire on input edges whose
+ *       IRQ is enabled, exactly like the hardware would call them.
+ *     - An enabled PIO state machine samples the inputs on its
+ *       clock into DMA; a DMA IRQ raised while interrupts are
+ *       disabled runs when restore_interrupts() re-enables them.
+ ****************************************************************/
+
+#include "pico.h"
+#include "hardware/gpio.h"
+
+namespace sim {
+
+// Return clock, GPIO and every timer to power-on state
+void reset();
+
+// Current virtual time in microseconds
+uint64_t nowUs();
+
+// Advance the clock, firing due timers and alarms on the way
+void advanceUs(uint64_t us);
+void advanceTo(uint64_t timeUs);
+
+// Advance the clock without firing anything, as if the CPU were held
+// with interrupts off (e.g. a flash erase); due events then fire late
+void stallUs(uint64_t us);
+
+// Drive an input pin; fires the GPIO callback if the edge is enabled
+void setPin(uint pin, bool level);
+
+// Drive several input pins at once; callbacks fire after all changed
+void setPins(uint32_t mask, uint32_t levels);
+
+// Callback registered with gpio_set_irq_enabled_with_callback, for
+// benchmarks that call it directly without the setPins() overhead
+gpio_irq_callback_t gpioIrqCallback();
+
+// Last level written with gpio_put
+bool outputLevel(uint pin);
+
+// Duty cycle (0..1) a PWM pin outputs: level / (wrap + 1), 0 if disabled
+float pwmDuty(uint pin);
+
+// The next count add_alarm_in_us calls fail (return -1), as with
+// no free slot in the alarm pool
+void failAlarms(uint32_t count);
+
+// Input characters returned by getchar_timeout_us
+void pushInput(const char* text);
+
+} // namespace sim
+
+#endif // SIM_HPP
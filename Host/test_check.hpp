@@ -0,0 +1,31 @@
+#ifndef TEST_CHECK_HPP
+#define TEST_CHECK_HPP
+
+/***************************************************************
+ * Host test checks
+ * Description:
+ *     - check() prints a failed condition and clears ok; the test
+ *       keeps running so one run reports every failure.
+ *     - main() ends with test_result(), which prints PASS or FAIL
+ *       and returns the exit code.
+ *     - One test per executable: ok is per translation unit.
+ ****************************************************************/
+
+#include <cstdio>
+
+static bool ok = true;
+
+static inline bool check(bool cond, const char* what) {
+    if (!cond) {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+    return cond;
+}
+
+static inline int test_result() {
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+#endif // TEST_CHECK_HPP
@@ -0,0 +1,96 @@
+/***************************************************************
+ *  File: test_cpu_profiler.cpp
+ *  Description:
+ *      - Plays a fixed schedule of zones on the virtual clock,
+ *        with an IRQ nested inside the control loop, and checks
+ *        the rolling percentages and the peak window.
+ *      - Reports the cost of one enter/exit pair.
+ ****************************************************************/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "sim.hpp"
+#include "test_check.hpp"
+#include "Profiler/cpu_profiler.hpp"
+
+static bool near(float a, float b) { return std::fabs(a - b) < 0.05f; }
+
+// One 1 ms loop: 100 us control (20 us of it in an encoder IRQ),
+// 100 us telemetry, 100 us untagged, idleUs idle, rest untagged
+static void loop(uint32_t idleUs) {
+    PROFILE_ENTER(CONTROL_LOOP);
+    sim::advanceUs(40);
+    PROFILE_ENTER(ENCODER_ISR);
+    sim::advanceUs(20);
+    PROFILE_EXIT();
+    sim::advanceUs(40);
+    PROFILE_EXIT();
+
+    PROFILE_ENTER(TELEMETRY_IO);
+    sim::advanceUs(100);
+    PROFILE_EXIT();
+
+    sim::advanceUs(100);
+
+    PROFILE_ENTER(IDLE);
+    sim::advanceUs(idleUs);
+    PROFILE_EXIT();
+
+    sim::advanceUs(700 - idleUs);
+}
+
+static float zone(const CpuLoadReport& r, ProfileZone z) { return r.percent[static_cast<int>(z)]; }
+
+int main() {
+    sim::reset();
+    CpuProfiler::profiler_reset();
+
+    CpuLoadReport r;
+    loop(700);
+    check(!CpuProfiler::profiler_getReport(0, r), "no report before the first window");
+    check(!CpuProfiler::profiler_getReport(CPU_PROFILER_CORES, r), "unknown core");
+
+    // Steady state: 30 % load over the whole rolling span
+    for (int i = 1; i < 2 * CPU_PROFILER_HISTORY * CPU_PROFILER_WINDOW_US / 1000; i++) loop(700);
+    loop(700);  // Crosses the last window end
+    check(CpuProfiler::profiler_getReport(0, r), "report after windows closed");
+    printf("steady: span %lu us, load %.2f%%, peak %.2f%%\n", (unsigned long)r.spanUs, r.loadPercent,
+           r.peakLoadPercent);
+    check(near(zone(r, ProfileZone::ENCODER_ISR), 2.0f), "ISR share");
+    check(near(zone(r, ProfileZone::CONTROL_LOOP), 8.0f), "control share excludes nested ISR");
+    check(near(zone(r, ProfileZone::TELEMETRY_IO), 10.0f), "telemetry share");
+    check(near(zone(r, ProfileZone::OTHER), 10.0f), "untagged share");
+    check(near(zone(r, ProfileZone::IDLE), 70.0f), "idle share");
+    check(near(r.loadPercent, 30.0f), "load");
+    check(r.peakLoadPercent < 30.5f, "steady peak");
+
+    // One busy window (40 % idle) stands out in the peak, not in the average
+    for (int i = 0; i < CPU_PROFILER_WINDOW_US / 1000; i++) loop(400);
+    for (int i = 0; i < CPU_PROFILER_WINDOW_US / 1000; i++) loop(700);
+    check(CpuProfiler::profiler_getReport(0, r), "report after burst");
+    printf("burst:  span %lu us, load %.2f%%, peak %.2f%%\n", (unsigned long)r.spanUs, r.loadPercent,
+           r.peakLoadPercent);
+    check(r.peakLoadPercent > 59.0f && r.peakLoadPercent < 61.0f, "peak window");
+    check(near(r.loadPercent, 33.0f), "rolling load includes the burst once");
+
+    // The burst ages out of the rolling span, the peak stays until reset
+    for (int i = 0; i < CPU_PROFILER_HISTORY * CPU_PROFILER_WINDOW_US / 1000; i++) loop(700);
+    CpuProfiler::profiler_getReport(0, r);
+    check(near(r.loadPercent, 30.0f) && r.peakLoadPercent > 59.0f, "burst ages out");
+    CpuProfiler::profiler_reset();
+    check(!CpuProfiler::profiler_getReport(0, r), "reset clears history");
+
+    CpuProfiler::profiler_printSummary();
+
+    // Instrumentation cost on this host
+    const int kPairs = 5000000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kPairs; i++) {
+        PROFILE_ZONE(ENCODER_ISR);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    printf("enter/exit pair: %.1f ns\n", std::chrono::duration<double, std::nano>(t1 - t0).count() / kPairs);
+
+    return test_result();
+}
@@ -0,0 +1,137 @@
+/***************************************************************
+ *  File: test_encoder_dma.cpp
+ *  Description:
+ *      - Runs EncoderDMA on the simulated PIO sampler and DMA
+ *        ping-pong with two encoders moving at different rates.
+ *      - Holds interrupts off for one and a half, then six blocks,
+ *        so the DMA IRQ runs more than a block late: the channels
+ *        must stay inside their buffers (guard words after the
+ *        backend are intact), the overrun must be counted, the
+ *        decoder must resume without invalid transitions, and
+ *        counting must be exact again afterwards.
+ ****************************************************************/
+
+#include <cstdio>
+#include "sim.hpp"
+#include "quadrature_gen.hpp"
+#include "test_check.hpp"
+#include "hardware/sync.h"
+#include "Encoder/encoder_hal.hpp"
+#include "Encoder/encoder_dma.hpp"
+
+static const uint64_t kBlockUs = ENCODER_DMA_BLOCK_SAMPLES * 1000000ull / ENCODER_DMA_SAMPLE_HZ;
+static const uint64_t kEdge1Us = 47;            // Encoder 1 forward
+static const uint64_t kEdge2Us = 113;           // Encoder 2 backward
+static const uint32_t kGuard = 0xA5C3A5C3u;
+static const int kGuardWords = 1024;
+
+// Backend followed by guard words that a runaway DMA write would hit
+struct Rig {
+    EncoderDMA dma;
+    uint32_t guard[kGuardWords];
+};
+
+static Rig rig;
+
+struct Motion {
+    QuadratureGen& gen1;
+    QuadratureGen& gen2;
+    uint64_t next1, next2;
+
+    // Moves both encoders for the given time
+    void run(uint64_t us) {
+        uint64_t end = sim::nowUs() + us;
+        while (true) {
+            uint64_t t = next1 < next2 ? next1 : next2;
+            if (t > end) break;
+            sim::advanceTo(t);
+            if (t == next1) { gen1.step(1); next1 += kEdge1Us; }
+            if (t == next2) { gen2.step(-1); next2 += kEdge2Us; }
+        }
+        sim::advanceTo(end);
+    }
+
+    // Encoders at rest until every sample with an edge is decoded
+    void settle() {
+        sim::advanceUs(3 * kBlockUs);
+        next1 = sim::nowUs() + kEdge1Us;
+        next2 = sim::nowUs() + kEdge2Us;
+    }
+};
+
+static bool guardIntact() {
+    for (int i = 0; i < kGuardWords; i++) {
+        if (rig.guard[i] != kGuard) return false;
+    }
+    return true;
+}
+
+int main() {
+    sim::reset();
+    for (int i = 0; i < kGuardWords; i++) rig.guard[i] = kGuard;
+
+    EncoderHAL enc1(ENCODER1_PIN_A, ENCODER1_PIN_B);
+    EncoderHAL enc2(ENCODER2_PIN_A, ENCODER2_PIN_B);
+    QuadratureGen gen1(ENCODER1_PIN_A, ENCODER1_PIN_B);
+    QuadratureGen gen2(ENCODER2_PIN_A, ENCODER2_PIN_B);
+    enc1.encoder_init(EncoderMode::DMA);
+    enc2.encoder_init(EncoderMode::DMA);
+    rig.dma.encoder_dmaStart();
+
+    Motion motion = {gen1, gen2, 0, 0};
+    motion.settle();
+
+    // Phase 1: IRQ on time, every edge counted
+    motion.run(200000);
+    motion.settle();
+    printf("on time: %u passes, ticks %d / %d\n", rig.dma.encoder_dmaGetPasses(),
+           enc1.encoder_getTicks(), enc2.encoder_getTicks());
+    check(enc1.encoder_getTicks() == gen1.position() && enc2.encoder_getTicks() == gen2.position(),
+          "on-time decode is exact");
+    check(enc1.encoder_getErrorCount() == 0 && enc2.encoder_getErrorCount() == 0, "no errors on time");
+    check(rig.dma.encoder_dmaGetOverruns() == 0, "no overruns on time");
+
+    // Phase 2: IRQ held off by 1.5 blocks, then by 6 blocks
+    const uint64_t lateUs[2] = {kBlockUs * 3 / 2, kBlockUs * 6};
+    for (int n = 0; n < 2; n++) {
+        int32_t lost1 = gen1.position() - enc1.encoder_getTicks();
+        int32_t lost2 = gen2.position() - enc2.encoder_getTicks();
+        uint32_t passes = rig.dma.encoder_dmaGetPasses();
+        uint32_t overruns = rig.dma.encoder_dmaGetOverruns();
+
+        motion.run(3000);
+        uint32_t status = save_and_disable_interrupts();
+        motion.run(lateUs[n]);
+        restore_interrupts(status);
+        motion.run(50000);
+        motion.settle();
+
+        int32_t drop1 = gen1.position() - enc1.encoder_getTicks() - lost1;
+        int32_t drop2 = gen2.position() - enc2.encoder_getTicks() - lost2;
+        int32_t bound1 = static_cast<int32_t>((lateUs[n] + kBlockUs) / kEdge1Us + 1);
+        int32_t bound2 = static_cast<int32_t>((lateUs[n] + kBlockUs) / kEdge2Us + 1);
+        printf("late by %.2f ms: %u overruns, dropped %d / %d edges (bound %d / %d)\n",
+               lateUs[n] / 1000.0, rig.dma.encoder_dmaGetOverruns() - overruns,
+               drop1, -drop2, bound1, bound2);
+
+        check(guardIntact(), "DMA wrote outside its buffers");
+        check(rig.dma.encoder_dmaGetOverruns() == overruns + 1, "late IRQ counted as one overrun");
+        check(rig.dma.encoder_dmaGetPasses() > passes, "decoding continues after a late IRQ");
+        check(drop1 >= 0 && drop1 <= bound1 && -drop2 >= 0 && -drop2 <= bound2,
+              "only samples from the late window are dropped");
+        check(enc1.encoder_getErrorCount() == 0 && enc2.encoder_getErrorCount() == 0,
+              "decoder resumes without invalid transitions");
+
+        // Exact again once the IRQ is back on time
+        int32_t base1 = gen1.position() - enc1.encoder_getTicks();
+        int32_t base2 = gen2.position() - enc2.encoder_getTicks();
+        motion.run(100000);
+        motion.settle();
+        check(gen1.position() - enc1.encoder_getTicks() == base1 &&
+              gen2.position() - enc2.encoder_getTicks() == base2,
+              "counting exact after recovery");
+    }
+
+    check(guardIntact(), "guard words intact");
+    return test_result();
+}
@@ -0,0 +1,116 @@
+/***************************************************************
+ *  File: test_glitch.cpp
+ *  Description:
+ *      - Injects PWM-like spikes between real encoder edges and
+ *        checks the glitch filter keeps the count exact.
+ *      - Bounces each real edge right after it and checks the
+ *        settled level is still decoded.
+ *      - Injects a noise burst and checks the encoder is masked,
+ *        re-enabled by the timer, and keeps counting afterwards.
+ *      - Fails the settle alarm once and checks the failure is
+ *        counted and the next bounce still settles.
+ ****************************************************************/
+
+#include <cstdio>
+#include "sim.hpp"
+#include "quadrature_gen.hpp"
+#include "test_check.hpp"
+#include "Encoder/encoder_hal.hpp"
+
+int main() {
+    sim::reset();
+
+    EncoderHAL encoder(ENCODER1_PIN_A, ENCODER1_PIN_B);
+    QuadratureGen gen(ENCODER1_PIN_A, ENCODER1_PIN_B);
+    encoder.encoder_init();
+
+    uint64_t t = 1000;
+
+    // Phase 1: 200 us edges, a 2 us spike on A after every 3rd edge
+    for (int i = 0; i < 300; i++) {
+        sim::advanceTo(t);
+        gen.step(1);
+        if (i % 3 == 0) {
+            uint8_t s = gen.state();
+            sim::advanceTo(t + 40);
+            sim::setPin(ENCODER1_PIN_A, !((s >> 1) & 1u));
+            sim::advanceTo(t + 42);
+            sim::setPin(ENCODER1_PIN_A, (s >> 1) & 1u);
+        }
+        t += 200;
+    }
+    check(encoder.encoder_getTicks() == gen.position(), "spikes changed the count");
+    check(encoder.encoder_getGlitchCount() == 100, "spikes not counted as glitches");
+    check(encoder.encoder_getStormCount() == 0, "isolated spikes treated as a storm");
+
+    // Phase 2: every edge bounces once, 1 us after it for 2 us
+    int32_t ticks = encoder.encoder_getTicks();
+    uint32_t glitches = encoder.encoder_getGlitchCount();
+    for (int i = 0; i < 100; i++) {
+        uint8_t before = gen.state();
+        sim::advanceTo(t);
+        gen.step(1);
+        uint8_t after = gen.state();
+        uint pin = ((before ^ after) & 2u) ? ENCODER1_PIN_A : ENCODER1_PIN_B;
+        bool level = ((before ^ after) & 2u) ? ((after >> 1) & 1u) : (after & 1u);
+        sim::advanceTo(t + 1);
+        sim::setPin(pin, !level);
+        sim::advanceTo(t + 3);
+        sim::setPin(pin, level);
+        t += 1000;
+    }
+    sim::advanceTo(t);
+    check(encoder.encoder_getTicks() - ticks == 100, "bounced edges lost");
+    check(encoder.encoder_getErrorCount() == 0, "bounce caused decode errors");
+    check(encoder.encoder_getGlitchCount() - glitches == 200, "bounces not counted as glitches");
+    check(encoder.encoder_getStormCount() == 0, "bounce treated as a storm");
+
+    // Phase 3: noise burst on B, 1 us toggles for 200 us
+    uint8_t s = gen.state();
+    for (int i = 0; i < 200; i++) {
+        sim::advanceTo(t + i);
+        sim::setPin(ENCODER1_PIN_B, (i & 1) ? (s & 1u) : !(s & 1u));
+    }
+    sim::setPin(ENCODER1_PIN_B, s & 1u);
+    t += 1000;
+    check(encoder.encoder_isMasked(), "storm did not mask the encoder");
+    check(encoder.encoder_getStormCount() == 1, "storm count");
+    check(encoder.encoder_getTicks() == gen.position(), "noise burst changed the count");
+
+    // Phase 4: mask expires, encoder counts again
+    t += ENCODER_STORM_MASK_US;
+    sim::advanceTo(t);
+    check(!encoder.encoder_isMasked(), "encoder not re-enabled");
+    for (int i = 0; i < 100; i++) {
+        sim::advanceTo(t);
+        gen.step(-1);
+        t += 150;
+    }
+    check(encoder.encoder_getTicks() == gen.position(), "count wrong after unmask");
+    check(encoder.encoder_getErrorCount() == 0, "decode errors");
+
+    // Phase 5: no alarm slot for the first settle, bounced edges as in phase 2
+    t += 1000;
+    sim::failAlarms(1);
+    for (int i = 0; i < 10; i++) {
+        uint8_t before = gen.state();
+        sim::advanceTo(t);
+        gen.step(1);
+        uint8_t after = gen.state();
+        uint pin = ((before ^ after) & 2u) ? ENCODER1_PIN_A : ENCODER1_PIN_B;
+        bool level = ((before ^ after) & 2u) ? ((after >> 1) & 1u) : (after & 1u);
+        sim::advanceTo(t + 1);
+        sim::setPin(pin, !level);
+        sim::advanceTo(t + 3);
+        sim::setPin(pin, level);
+        t += 1000;
+    }
+    sim::advanceTo(t);
+    check(encoder.encoder_getAlarmFailureCount() == 1, "alarm failure not counted");
+    check(encoder.encoder_getTicks() == gen.position(), "bounces lost after an alarm failure");
+
+    printf("%s: ticks=%ld glitches=%lu storms=%lu\n", ok ? "PASS" : "FAIL",
+           (long)encoder.encoder_getTicks(), (unsigned long)encoder.encoder_getGlitchCount(),
+           (unsigned long)encoder.encoder_getStormCount());
+    return ok ? 0 : 1;
+}
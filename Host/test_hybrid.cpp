@@ -0,0 +1,123 @@
+/***************************************************************
+ *  File: test_hybrid.cpp
+ *  Description:
+ *      - Runs two encoders at up to the rated edge rate, the
+ *        highest the motors produce, with +-10 % speed jitter.
+ *      - Passes when every generated edge is counted with no
+ *        decode errors, both encoders at the rated rate switch
+ *        to polling, one encoder at the rated rate does not, and
+ *        polling ran fewer IRQs than the edges it replaced.
+ ****************************************************************/
+
+#include <cstdio>
+#include "sim.hpp"
+#include "quadrature_gen.hpp"
+#include "Encoder/encoder_hal.hpp"
+
+static const uint64_t kRatedUs = 1000000 / ENCODER_RATED_EDGE_RATE;    // ~866 us/edge
+static const uint64_t kSlowUs = kRatedUs * 14;                         // ~7 % of rated
+
+// Edge interval of encoder e for a speed profile: slow, both rated,
+// slow, encoder 1 alone rated, both rated backwards, slow
+static uint64_t intervalUs(uint64_t t, int e, int& dir) {
+    dir = 1;
+    if (t < 200000) return kSlowUs;
+    if (t < 400000) return kRatedUs;
+    if (t < 600000) return kSlowUs;
+    if (t < 800000) return (e == 0) ? kRatedUs : kSlowUs;
+    dir = -1;
+    if (t < 1000000) return kRatedUs;
+    return kSlowUs;
+}
+
+// Up to +-10 % around the nominal interval
+static uint64_t jitter(uint64_t us, unsigned& seed) {
+    seed = seed * 1103515245u + 12345u;
+    return us - us / 10 + ((seed >> 16) % (us / 5 + 1));
+}
+
+int main() {
+    sim::reset();
+
+    EncoderHAL encoder1(ENCODER1_PIN_A, ENCODER1_PIN_B);
+    EncoderHAL encoder2(ENCODER2_PIN_A, ENCODER2_PIN_B);
+    QuadratureGen gen1(ENCODER1_PIN_A, ENCODER1_PIN_B);
+    QuadratureGen gen2(ENCODER2_PIN_A, ENCODER2_PIN_B);
+    encoder1.encoder_init();
+    encoder2.encoder_init();
+    EncoderHAL::encoder_startHybrid();
+
+    // Encoder 2 is offset by a fraction of a period so edges interleave
+    uint64_t next1 = 0, next2 = 17;
+    unsigned seed = 1;
+    int polledWindows = 0, switches = 0;
+    bool polledSingle = false;
+    uint64_t pollingUs = 0, lastUs = 0;
+    uint32_t polledEdges = 0;
+    EncoderMode last = EncoderHAL::encoder_getMode();
+
+    while (next1 < 1200000 || next2 < 1200000) {
+        int dir;
+        bool first = next1 <= next2;
+        uint64_t t = first ? next1 : next2;
+        sim::advanceTo(t);
+        if (last == EncoderMode::POLLING) pollingUs += t - lastUs;
+        lastUs = t;
+
+        if (first) {
+            next1 += jitter(intervalUs(next1, 0, dir), seed);
+            gen1.step(dir);
+        } else {
+            next2 += jitter(intervalUs(next2, 1, dir), seed);
+            gen2.step(dir);
+        }
+
+        EncoderMode mode = EncoderHAL::encoder_getMode();
+        if (mode != last) {
+            switches++;
+            last = mode;
+        }
+        if (mode == EncoderMode::POLLING) {
+            polledWindows++;
+            polledEdges++;
+            if (t >= 620000 && t < 800000) polledSingle = true;   // After the hysteresis settles
+        }
+    }
+    sim::advanceUs(100000);
+
+    bool ok = true;
+    if (encoder1.encoder_getTicks() != gen1.position() || encoder2.encoder_getTicks() != gen2.position()) {
+        printf("FAIL: lost counts: enc1 %ld/%ld enc2 %ld/%ld\n",
+               (long)encoder1.encoder_getTicks(), (long)gen1.position(),
+               (long)encoder2.encoder_getTicks(), (long)gen2.position());
+        ok = false;
+    }
+    if (encoder1.encoder_getErrorCount() != 0 || encoder2.encoder_getErrorCount() != 0) {
+        printf("FAIL: decode errors: enc1 %lu enc2 %lu\n",
+               (unsigned long)encoder1.encoder_getErrorCount(),
+               (unsigned long)encoder2.encoder_getErrorCount());
+        ok = false;
+    }
+    if (switches < 4 || polledWindows == 0) {
+        printf("FAIL: expected two polling phases, saw %d mode switches\n", switches);
+        ok = false;
+    }
+    if (polledSingle) {
+        printf("FAIL: one encoder at the rated rate switched to polling\n");
+        ok = false;
+    }
+    uint64_t polls = pollingUs / ENCODER_POLL_PERIOD_US;
+    printf("polling: %llu polls replaced %lu edge IRQs\n", (unsigned long long)polls, (unsigned long)polledEdges);
+    if (polls * ENCODER_POLL_COST_EDGES >= polledEdges) {
+        printf("FAIL: polling cost more IRQs than it replaced\n");
+        ok = false;
+    }
+    if (EncoderHAL::encoder_getMode() != EncoderMode::INTERRUPT) {
+        printf("FAIL: decoder did not return to INTERRUPT mode\n");
+        ok = false;
+    }
+
+    printf("%s: %d mode switches, ticks enc1=%ld enc2=%ld\n", ok ? "PASS" : "FAIL", switches,
+           (long)encoder1.encoder_getTicks(), (long)encoder2.encoder_getTicks());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+/***************************************************************
+ *  File: test_motor_monitor.cpp
+ *  Description:
+ *      - Closes the speed loop on the virtual clock: HBridge pins
+ *        drive a first-order motor model whose shaft generates
+ *        quadrature edges into EncoderHAL; EncoderService samples
+ *        them, MotorPID and MotorMonitor run on every sample as
+ *        in the application loop.
+ *      - Injects a jam, an unplugged encoder, a lost channel,
+ *        swapped motor leads, swapped encoder channels, an
+ *        externally driven overspeed and a wheel spun at 150 RPM
+ *        with the duty held at 0, and checks each is detected
+ *        as the right fault within the latency bound, with the
+ *        bridge stopped in the detecting tick and kept stopped.
+ *      - A healthy run with reversals must not trip.
+ ****************************************************************/
+
+#include <cmath>
+#include <cstdio>
+#include "sim.hpp"
+#include "quadrature_gen.hpp"
+#include "test_check.hpp"
+#include "Encoder/encoder_hal.hpp"
+#include "Encoder/encoder_service.hpp"
+#include "Encoder/sample_event.hpp"
+#include "Motor/Motor.hpp"
+#include "Motor/motor_monitor.hpp"
+#include "PID.hpp"
+
+static const uint64_t kPeriodUs = ENCODER_SAMPLE_PERIOD_MS * 1000ull;
+static const uint64_t kStepUs = 50;             // Motor model integration step
+static const uint32_t kFaultTick = 20;          // Injection, after the start-up transient
+static const uint32_t kBoundTicks = MONITOR_TRIP_TICKS + 1;
+
+enum class Injection { NONE, JAM, UNPLUG, LOSE_B, SWAP_LEADS, SWAP_AB, OVERSPEED, SPIN };
+
+/***************************************************************
+ * Motor and encoder model
+ * Description:
+ *     - Speed follows duty x kFullRpm with time constant kTau,
+ *       direction from the IN1/IN2 outputs and duty from the PWM
+ *       level, both read back from the simulated SDK.
+ *     - Shaft position steps a QuadratureGen, ENCODER_CPR edges
+ *       per turn; wire faults rewrite its pin levels before they
+ *       reach the encoder.
+ ****************************************************************/
+struct MotorModel {
+    static constexpr float kFullRpm = 250.0f;
+    static constexpr float kTau = 0.08f;
+    static constexpr float kOverspeedRpm = 400.0f;
+    static constexpr float kSpinRpm = 150.0f;
+
+    Injection fault = Injection::NONE;
+    float rpm = 0.0f;
+    float position = 0.0f;      // Edges, fractional
+    QuadratureGen gen{ENCODER1_PIN_A, ENCODER1_PIN_B};
+
+    float drive() const {
+        bool in1 = sim::outputLevel(MOTOR_A_IN1);
+        bool in2 = sim::outputLevel(MOTOR_A_IN2);
+        float sign = (in1 && !in2) ? 1.0f : (in2 && !in1) ? -1.0f : 0.0f;
+        if (fault == Injection::SWAP_LEADS) sign = -sign;
+        return sign * sim::pwmDuty(MOTOR_A_EN);
+    }
+
+    void step(float dt) {
+        float target = drive() * kFullRpm;
+        if (fault == Injection::OVERSPEED) target = kOverspeedRpm;  // Bridge no longer in control
+        if (fault == Injection::SPIN) target = kSpinRpm;            // Below full speed, but undriven
+        rpm += (target - rpm) * dt / kTau;
+        if (fault == Injection::JAM) rpm = 0.0f;
+
+        position += rpm / 60.0f * ENCODER_CPR * dt;
+        while (position >= 1.0f) { position -= 1.0f; edge(1); }
+        while (position <= -1.0f) { position += 1.0f; edge(-1); }
+    }
+
+    void edge(int dir) {
+        gen.advance(dir);
+        uint8_t s = gen.state();
+        bool a = (s >> 1) & 1u, b = s & 1u;
+        switch (fault) {
+            case Injection::UNPLUG:  a = true; b = true; break;     // Pull-ups
+            case Injection::LOSE_B:  b = true; break;
+            case Injection::SWAP_AB: { bool t = a; a = b; b = t; break; }
+            default: gen.apply(); return;
+        }
+        sim::setPins(gen.mask(), (a ? 1u << ENCODER1_PIN_A : 0u) | (b ? 1u << ENCODER1_PIN_B : 0u));
+    }
+};
+
+static bool bridgeStopped() {
+    return !sim::outputLevel(MOTOR_A_IN1) && !sim::outputLevel(MOTOR_A_IN2) && sim::pwmDuty(MOTOR_A_EN) == 0.0f;
+}
+
+/***************************************************************
+ * Closed-loop rig: the application's control tick
+ ****************************************************************/
+struct Rig {
+    EncoderHAL encoder;
+    EncoderService service;
+    HBridge bridge;
+    Motor motor;
+    MotorPID::PIDINPUT pidIn;
+    MotorPID pid;
+    MotorMonitor monitor;
+    MotorModel model;
+    uint32_t seq;
+    uint32_t tick;
+    bool holdDuty;              // Command 0 instead of the PID output
+
+    static MotorPID::PIDINPUT input() {
+        MotorPID::PIDINPUT in = {MOTOR_PID_KP, MOTOR_PID_KI, MOTOR_PID_KD, ENCODER_SAMPLE_PERIOD_MS / 1000.0f,
+                                 120.0f, MOTOR_PID_KFF, MOTOR_PID_D_FILTER_TAU, MOTOR_PID_KAW, MOTOR_PID_SLEW_RATE};
+        return in;
+    }
+
+    Rig() : encoder((sim::reset(), ENCODER1_PIN_A), ENCODER1_PIN_B), service(encoder),
+            bridge(MOTOR_A_IN1, MOTOR_A_IN2, MOTOR_A_EN), motor(bridge),
+            pidIn(input()), pid(&pidIn), monitor(motor, bridge, encoder, service),
+            seq(0), tick(0), holdDuty(false) {
+        encoder.encoder_init();
+        service.encoder_start();
+        motor.init();
+        seq = SampleEvent::event_getSequence();
+    }
+
+    // Runs the model up to the next sample, then one control tick.
+    // Returns true when the monitor latched a fault in this tick.
+    bool runTick() {
+        while (SampleEvent::event_getSequence() == seq) {
+            model.step(kStepUs * 1e-6f);
+            sim::advanceUs(kStepUs);
+        }
+        seq = SampleEvent::event_getSequence();
+        tick++;
+
+        bool tripped = monitor.monitor_tick();
+        float throttle = pid.UpdateThrottle(service.encoder_getRPM());
+        motor.setSpeed(holdDuty ? 0.0f : throttle);     // Locked out after a trip
+        return tripped;
+    }
+};
+
+/***************************************************************
+ * Scenarios
+ ****************************************************************/
+static void testHealthy() {
+    Rig rig;
+    bool tripped = false;
+    float minRpm = 0.0f;
+    for (int t = 0; t < 90; t++) {
+        if (t == 30) rig.pid.SetSpeedRPM(120.0f, false);
+        if (t == 60) rig.pid.SetSpeedRPM(60.0f, true);
+        tripped |= rig.runTick();
+        if (rig.service.encoder_getRPM() < minRpm) minRpm = rig.service.encoder_getRPM();
+    }
+    printf("healthy: end %.1f RPM, min %.1f RPM, fault %s\n", rig.service.encoder_getRPM(), minRpm,
+           MotorMonitor::monitor_faultName(rig.monitor.monitor_getFault()));
+    check(!tripped && rig.monitor.monitor_getFault() == MotorFault::NONE, "healthy run with reversals does not trip");
+    check(minRpm < -100.0f && std::fabs(rig.service.encoder_getRPM() - 60.0f) < 10.0f, "healthy run tracks the target");
+}
+
+static void testFault(const char* name, Injection injection, MotorFault expected, bool holdDuty = false) {
+    Rig rig;
+    char what[96];
+    rig.holdDuty = holdDuty;
+    for (uint32_t t = 0; t < kFaultTick; t++) rig.runTick();
+    check(rig.monitor.monitor_getFault() == MotorFault::NONE, "no fault before injection");
+
+    rig.model.fault = injection;
+    uint64_t injectUs = sim::nowUs();
+    uint32_t injectTick = rig.tick;
+    bool tripped = false;
+    bool stoppedInTick = false;
+    while (!tripped && rig.tick < injectTick + 4 * kBoundTicks) {
+        tripped = rig.runTick();
+        stoppedInTick = bridgeStopped();
+    }
+
+    uint32_t ticks = rig.tick - injectTick;
+    uint64_t latencyUs = static_cast<uint64_t>(rig.monitor.monitor_getTripUs()) - injectUs;
+    printf("%-14s -> %-12s in %u ticks (%.1f ms, bound %u ticks)\n", name,
+           MotorMonitor::monitor_faultName(rig.monitor.monitor_getFault()),
+           ticks, latencyUs / 1000.0, kBoundTicks);
+
+    snprintf(what, sizeof(what), "%s: detected as %s", name, MotorMonitor::monitor_faultName(expected));
+    check(rig.monitor.monitor_getFault() == expected, what);
+    snprintf(what, sizeof(what), "%s: within the latency bound", name);
+    check(tripped && ticks <= kBoundTicks && latencyUs <= kBoundTicks * kPeriodUs, what);
+    snprintf(what, sizeof(what), "%s: bridge stopped in the detecting tick", name);
+    check(stoppedInTick, what);
+
+    // The loop keeps calling setSpeed; the lockout must hold
+    bool held = true;
+    for (int t = 0; t < 10; t++) {
+        rig.runTick();
+        held &= bridgeStopped() && rig.motor.getCommand() == 0.0f;
+    }
+    snprintf(what, sizeof(what), "%s: cutoff latched", name);
+    check(held && rig.monitor.monitor_getFault() == expected, what);
+}
+
+// After the cause is gone, clearing resumes control from rest
+static void testClear() {
+    Rig rig;
+    for (uint32_t t = 0; t < kFaultTick; t++) rig.runTick();
+    rig.model.fault = Injection::JAM;
+    for (uint32_t t = 0; t < kBoundTicks; t++) rig.runTick();
+    check(rig.monitor.monitor_getFault() == MotorFault::STALL, "jam latched before clear");
+
+    rig.model.fault = Injection::NONE;
+    rig.monitor.monitor_clear();
+    rig.pid.Reset();
+    rig.pid.SetSpeedRPM(100.0f, true);
+    bool tripped = false;
+    for (int t = 0; t < 40; t++) tripped |= rig.runTick();
+    printf("clear: %.1f RPM after restart\n", rig.service.encoder_getRPM());
+    check(!tripped && !rig.motor.isLockedOut(), "no fault after clear");
+    check(std::fabs(rig.service.encoder_getRPM() - 100.0f) < 10.0f, "control resumes after clear");
+}
+
+int main() {
+    testHealthy();
+    testFault("jam", Injection::JAM, MotorFault::STALL);
+    testFault("unplugged", Injection::UNPLUG, MotorFault::STALL);
+    testFault("lost B", Injection::LOSE_B, MotorFault::ENCODER_LOSS);
+    testFault("swapped leads", Injection::SWAP_LEADS, MotorFault::REVERSED);
+    testFault("swapped A/B", Injection::SWAP_AB, MotorFault::REVERSED);
+    testFault("overspeed", Injection::OVERSPEED, MotorFault::RUNAWAY);
+    testFault("spun at duty 0", Injection::SPIN, MotorFault::RUNAWAY, true);
+    testClear();
+
+    return test_result();
+}
@@ -0,0 +1,172 @@
+/***************************************************************
+ *  File: test_motor_pid.cpp
+ *  Description:
+ *      - Gain schedule interpolation and clamping.
+ *      - Bumpless gain and setpoint changes in both PID forms:
+ *        the step after a change moves the output only by the
+ *        integral action, never by a proportional kick.
+ *      - MotorPID keeps one integrator per direction: returning
+ *        to a direction resumes from the output learnt there,
+ *        within the slew limit. MotorPID runs the configured form;
+ *        test_motor_pid_positional builds this file for the other.
+ ****************************************************************/
+
+#include <cmath>
+#include <cstdio>
+#include "test_check.hpp"
+#include "PID.hpp"
+
+#if PID_CONTROLLER_FORM == PID_FORM_POSITIONAL
+#define MOTOR_PID_FORM_NAME "positional"
+#else
+#define MOTOR_PID_FORM_NAME "incremental"
+#endif
+
+static bool near(float a, float b, float tol = 1e-4f) { return std::fabs(a - b) <= tol; }
+
+static PIDConfig testConfig() {
+    PIDConfig cfg;
+    cfg.kp = 2.0f;
+    cfg.ki = 5.0f;
+    cfg.kd = 0.0f;
+    cfg.dt = 0.01f;
+    cfg.out_min = -MAX_RPM;
+    cfg.out_max = MAX_RPM;
+    cfg.d_filter_tau = 0.0f;
+    cfg.kaw = 0.0f;
+    cfg.slew_rate = 0.0f;
+    return cfg;
+}
+
+static void testSchedule() {
+    const PIDGains table[3] = {{1.0f, 10.0f, 0.0f}, {2.0f, 8.0f, 0.1f}, {4.0f, 4.0f, 0.2f}};
+    GainSchedule s;
+    check(!s.enabled(), "schedule starts disabled");
+    check(!s.configure(0.0f, 200.0f, table, 0), "empty table rejected");
+    check(!s.configure(100.0f, 100.0f, table, 3), "zero-width table rejected");
+    check(s.configure(0.0f, 200.0f, table, 3) && s.enabled(), "table accepted");
+
+    check(near(s.lookup(0.0f).kp, 1.0f) && near(s.lookup(100.0f).ki, 8.0f), "breakpoints");
+    check(near(s.lookup(50.0f).kp, 1.5f) && near(s.lookup(150.0f).kd, 0.15f), "interpolation");
+    check(near(s.lookup(-150.0f).kp, 3.0f), "either direction");
+    check(near(s.lookup(500.0f).kp, 4.0f) && near(s.lookup(-500.0f).ki, 4.0f), "clamped above");
+
+    GainSchedule low;
+    low.configure(20.0f, 200.0f, table, 3);
+    check(near(low.lookup(5.0f).kp, 1.0f), "clamped below");
+
+    GainSchedule single;
+    check(single.configure(0.0f, 0.0f, table + 1, 1) && near(single.lookup(77.0f).kp, 2.0f), "single point");
+}
+
+// Output change on the step after a gain or setpoint change, measurement held
+template <typename Form>
+static void testBumpless(const char* name) {
+    char what[96];
+    const float y = 80.0f;
+
+    PIDController<Form> c(testConfig());
+    for (int i = 0; i < 20; i++) c.step(100.0f, y);
+    float before = c.step(100.0f, y);
+
+    c.setGains(PIDGains{6.0f, 5.0f, 0.0f});
+    float after = c.step(100.0f, y);
+    snprintf(what, sizeof(what), "%s: gain change moves output by integral action only", name);
+    check(near(after - before, 5.0f * 20.0f * 0.01f, 1e-3f), what);
+
+    before = after;
+    c.retarget(10.0f);
+    after = c.step(110.0f, y);
+    snprintf(what, sizeof(what), "%s: setpoint change without proportional kick (%.3f)", name, after - before);
+    check(after - before < 5.0f * 30.0f * 0.01f + 1e-3f, what);
+
+    // Reference: the kick a plain setpoint change produces
+    PIDController<Form> plain(testConfig());
+    plain.setGains(PIDGains{6.0f, 5.0f, 0.0f});
+    for (int i = 0; i < 20; i++) plain.step(100.0f, y);
+    float b = plain.step(100.0f, y);
+    float a = plain.step(110.0f, y);
+    snprintf(what, sizeof(what), "%s: reference shows the kick", name);
+    check(a - b > 6.0f * 10.0f * 0.9f, what);
+}
+
+// First-order motor with Coulomb friction, speed in RPM
+struct Plant {
+    float rpm = 0.0f;
+    float step(float throttle) {
+        float drive = throttle * MAX_RPM * 0.9f;
+        float friction = (drive > 0.0f) ? 25.0f : (drive < 0.0f) ? -25.0f : 0.0f;
+        float target = (std::fabs(drive) > 25.0f) ? drive - friction : 0.0f;
+        rpm += (target - rpm) * 0.2f;
+        return rpm;
+    }
+};
+
+static void testDirection(float slewRate) {
+    char what[96];
+    MotorPID::PIDINPUT in = {0.2f, 4.0f, 0.0f, 0.01f, 100.0f, 0.0f, 0.0f, 10.0f, slewRate};
+    MotorPID pid(&in);
+    Plant plant;
+    const float maxStep = slewRate * in.dt / MAX_RPM;      // Throttle per step
+
+    float throttle = 0.0f;
+    for (int i = 0; i < 3000; i++) throttle = pid.UpdateThrottle(plant.step(throttle));
+    float cw = throttle;
+    snprintf(what, sizeof(what), "slew %.0f: CW settles", slewRate);
+    check(std::fabs(plant.rpm - 100.0f) < 1.0f, what);
+
+    pid.SetSpeedRPM(100.0f, false);
+    for (int i = 0; i < 3000; i++) throttle = pid.UpdateThrottle(plant.step(throttle));
+    float ccw = throttle;
+    snprintf(what, sizeof(what), "slew %.0f: CCW settles", slewRate);
+    check(std::fabs(plant.rpm + 100.0f) < 1.0f, what);
+
+    // Held plant: the output moves by the controller alone
+    pid.SetSpeedRPM(100.0f, true);
+    float first = pid.UpdateThrottle(plant.rpm);
+    bool slewed = maxStep == 0.0f || std::fabs(first - ccw) <= maxStep + 1e-5f;
+    float last = first;
+    int ramp = (maxStep > 0.0f) ? static_cast<int>(std::fabs(cw - ccw) / maxStep) + 2 : 0;
+    for (int i = 0; i < ramp; i++) {
+        float next = pid.UpdateThrottle(plant.rpm);
+        slewed &= std::fabs(next - last) <= maxStep + 1e-5f;
+        last = next;
+    }
+    printf("direction (%s, slew %.0f): cw %.3f ccw %.3f first after return %.3f, %.3f after %d steps\n",
+           MOTOR_PID_FORM_NAME, slewRate, cw, ccw, first, last, ramp);
+    snprintf(what, sizeof(what), "slew %.0f: restore respects the slew limit", slewRate);
+    check(slewed, what);
+    // Only the proportional and integral action on the reversal error remains
+    snprintf(what, sizeof(what), "slew %.0f: CW integrator restored on return", slewRate);
+    check(std::fabs(last - cw) < 0.25f * std::fabs(cw - ccw), what);
+}
+
+static void testScheduledMotorPID() {
+    MotorPID::PIDINPUT in = {0.5f, 4.0f, 0.0f, 0.01f, 0.0f, 0.0f, 0.0f, 10.0f, 0.0f};
+    MotorPID pid(&in);
+    const PIDGains table[3] = {{1.0f, 10.0f, 0.0f}, {2.0f, 8.0f, 0.0f}, {3.0f, 6.0f, 0.0f}};
+
+    check(pid.SetGainSchedule(MotorPID::ScheduleVariable::SETPOINT_RPM, 0.0f, 200.0f, table, 3), "MotorPID schedule");
+    pid.SetSpeedRPM(150.0f, true);
+    pid.UpdateThrottle(0.0f);
+    check(near(pid.GetGains().kp, 2.5f) && near(pid.GetGains().ki, 7.0f), "scheduled against setpoint");
+
+    check(pid.SetGainSchedule(MotorPID::ScheduleVariable::MEASURED_RPM, 0.0f, 200.0f, table, 3), "MotorPID schedule");
+    pid.UpdateThrottle(-50.0f);
+    check(near(pid.GetGains().kp, 1.5f), "scheduled against measurement");
+
+    pid.SetGains(0.7f, 3.0f, 0.0f);
+    pid.UpdateThrottle(150.0f);
+    check(near(pid.GetGains().kp, 0.7f), "SetGains disables the schedule");
+}
+
+int main() {
+    testSchedule();
+    testBumpless<PositionalPID>("positional");
+    testBumpless<IncrementalPID>("incremental");
+    testDirection(0.0f);
+    testDirection(2000.0f);
+    testScheduledMotorPID();
+
+    return test_result();
+}
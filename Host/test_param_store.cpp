@@ -0,0 +1,155 @@
+/***************************************************************
+ *  File: test_param_store.cpp
+ *  Description:
+ *      - Runs ParamStore on a file-backed 2 x 4 KB region with
+ *        flash semantics and "reboots" by reopening the file.
+ *      - Checks defaults, round trip, wear levelling across both
+ *        sectors, recovery from power cuts while programming and
+ *        while erasing, and fallback from a corrupted record.
+ *      - Reports the time of a boot-time load.
+ ****************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include "file_storage.hpp"
+#include "test_check.hpp"
+#include "Params/param_store.hpp"
+
+static const uint32_t kSector = 4096;
+static const uint32_t kSize = 2 * kSector;
+static const uint32_t kSlotsPerSector = kSector / PARAM_SLOT_SIZE;
+
+// Boot: fresh storage and store on the same file, then load
+static uint32_t bootSequence(const char* path, float* kiOut = nullptr) {
+    FileStorage storage(path, kSize, kSector);
+    ParamStore store(storage);
+    store.params_load();
+    if (kiOut) *kiOut = store.params_get().motor[0].ki;
+    return store.params_getSequence();
+}
+
+// Slot holding the record with this sequence
+static uint32_t slotOf(FileStorage& storage, uint32_t sequence) {
+    for (uint32_t s = 0; s < 2 * kSlotsPerSector; s++) {
+        ParamHeader h;
+        storage.nv_read(s * PARAM_SLOT_SIZE, &h, sizeof(h));
+        if (h.magic == PARAM_MAGIC && h.sequence == sequence) return s;
+    }
+    return UINT32_MAX;
+}
+
+int main(int argc, char** argv) {
+    const char* path = (argc > 1) ? argv[1] : "test_param_store.bin";
+    std::remove(path);
+
+    // Blank region: defaults, then a first save
+    {
+        FileStorage storage(path, kSize, kSector);
+        ParamStore store(storage);
+        check(!store.params_load(), "blank region has no record");
+        check(store.params_get().encoder[1].cpr == ENCODER_CPR, "default CPR");
+        check(store.params_getSequence() == 0, "default sequence");
+
+        store.params_get().encoder[1].cpr = 1200;
+        store.params_get().encoder[1].wheelRadiusCm = 3.25f;
+        store.params_get().encoder[1].inverted = 1;
+        store.params_get().motor[0].ki = 9.5f;
+        check(store.params_save(), "first save");
+    }
+    {
+        FileStorage storage(path, kSize, kSector);
+        ParamStore store(storage);
+        check(store.params_load(), "record found after reboot");
+        const ParamBlock& b = store.params_get();
+        check(b.encoder[1].cpr == 1200 && b.encoder[1].wheelRadiusCm == 3.25f && b.encoder[1].inverted == 1 &&
+              b.encoder[0].cpr == ENCODER_CPR && b.motor[0].ki == 9.5f, "round trip");
+    }
+
+    // Wear levelling: 100 saves spread over both sectors
+    const int kSaves = 100;
+    {
+        FileStorage storage(path, kSize, kSector);
+        ParamStore store(storage);
+        store.params_load();
+        for (int i = 0; i < kSaves; i++) {
+            store.params_get().motor[0].ki = static_cast<float>(i);
+            check(store.params_save(), "repeated save");
+        }
+        uint32_t maxErases = (kSaves + 1) / (2 * kSlotsPerSector) + 1;
+        printf("erases after %d saves: %u + %u\n", kSaves + 1, storage.eraseCount(0), storage.eraseCount(1));
+        check(storage.eraseCount(0) <= maxErases && storage.eraseCount(1) <= maxErases, "erases spread evenly");
+    }
+    float ki = -1.0f;
+    check(bootSequence(path, &ki) == kSaves + 1 && ki == kSaves - 1, "newest record after wrap");
+
+    // Power cut while programming: previous record survives, next save works
+    {
+        FileStorage storage(path, kSize, kSector);
+        ParamStore store(storage);
+        store.params_load();
+        store.params_get().motor[0].ki = 1234.0f;
+        storage.cutPowerAfter(20);
+        check(!store.params_save(), "torn program reported");
+    }
+    check(bootSequence(path, &ki) == kSaves + 1 && ki == kSaves - 1, "torn program ignored");
+    {
+        FileStorage storage(path, kSize, kSector);
+        ParamStore store(storage);
+        store.params_load();
+        store.params_get().motor[0].ki = 42.0f;
+        check(store.params_save(), "save after torn program");
+    }
+    check(bootSequence(path, &ki) == kSaves + 2 && ki == 42.0f, "save skips the torn slot");
+
+    // Power cut while erasing: fill up to the end of the current sector,
+    // then cut power during the erase of the other one
+    {
+        FileStorage storage(path, kSize, kSector);
+        ParamStore store(storage);
+        store.params_load();
+        for (uint32_t i = 0; i < 2 * kSlotsPerSector; i++) {
+            if (slotOf(storage, store.params_getSequence()) % kSlotsPerSector == kSlotsPerSector - 1) break;
+            check(store.params_save(), "fill sector");
+        }
+        uint32_t before = store.params_getSequence();
+        store.params_get().motor[0].ki = 77.0f;
+        storage.cutPowerAfter(kSector / 2);
+        check(!store.params_save(), "torn erase reported");
+        storage.restorePower();
+        check(bootSequence(path) == before, "record survives torn erase of the other sector");
+    }
+
+    // Corruption of the newest record falls back to the one before
+    {
+        FileStorage storage(path, kSize, kSector);
+        ParamStore store(storage);
+        store.params_load();
+        store.params_get().motor[0].ki = 5.0f;
+        store.params_save();
+        store.params_get().motor[0].ki = 6.0f;
+        store.params_save();
+        uint32_t slot = slotOf(storage, store.params_getSequence());
+        storage.image()[slot * PARAM_SLOT_SIZE + sizeof(ParamHeader) + 3] ^= 0x10;
+        storage.flush();
+    }
+    ki = -1.0f;
+    check(bootSequence(path, &ki) > 0 && ki == 5.0f, "CRC rejects corrupted record");
+
+    // Boot-time load on a full region
+    {
+        FileStorage storage(path, kSize, kSector);
+        const int kLoads = 20000;
+        volatile uint32_t sink = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < kLoads; i++) {
+            ParamStore store(storage);
+            store.params_load();
+            sink = sink + store.params_getSequence();
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        printf("params_load: %.2f us\n", std::chrono::duration<double, std::micro>(t1 - t0).count() / kLoads);
+    }
+
+    std::remove(path);
+    return test_result();
+}
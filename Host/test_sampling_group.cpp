@@ -0,0 +1,75 @@
+/***************************************************************
+ *  File: test_sampling_group.cpp
+ *  Description:
+ *      - Samples an encoder turning at constant speed through an
+ *        EncoderSamplingGroup on the virtual clock.
+ *      - Stalls the clock past a sample target, as a flash erase
+ *        would, so the alarm runs late and the next period is
+ *        skipped: the sample spanning two periods must still read
+ *        the true speed, not twice it.
+ *      - A period other than ENCODER_SAMPLE_PERIOD_MS is refused.
+ ****************************************************************/
+
+#include <cmath>
+#include <cstdio>
+#include "sim.hpp"
+#include "quadrature_gen.hpp"
+#include "test_check.hpp"
+#include "Encoder/encoder_hal.hpp"
+#include "Encoder/encoder_service.hpp"
+#include "Encoder/encoder_sampling_group.hpp"
+
+static const uint64_t kPeriodUs = ENCODER_SAMPLE_PERIOD_MS * 1000ull;
+static const uint64_t kEdgeUs = 1000;
+static const float kRpm = 1e6f / kEdgeUs / ENCODER_CPR * 60.0f;
+
+static bool near(float rpm) { return std::fabs(rpm - kRpm) <= kRpm * 0.02f; }
+
+int main() {
+    sim::reset();
+
+    EncoderHAL encoder(ENCODER1_PIN_A, ENCODER1_PIN_B);
+    QuadratureGen gen(ENCODER1_PIN_A, ENCODER1_PIN_B);
+    encoder.encoder_init();
+    encoder.encoder_setGlitchFilter(0);     // Edges held during the stall arrive together
+    EncoderService service(encoder);
+
+    EncoderSamplingGroup group;
+    check(group.group_add(service), "member added");
+    check(!group.group_start(kPeriodUs / 2), "other period refused");
+    uint64_t start = sim::nowUs();
+    check(group.group_start(), "group started");
+
+    // Constant speed: one edge per kEdgeUs
+    uint64_t next = start + kEdgeUs / 2;
+    auto run = [&](uint64_t until) {
+        for (; next <= until; next += kEdgeUs) {
+            sim::advanceTo(next);
+            gen.step(1);
+        }
+        sim::advanceTo(until);
+    };
+
+    run(start + 5 * kPeriodUs + 1);
+    printf("on time: %.1f RPM (true %.1f)\n", service.encoder_getRPM(), kRpm);
+    check(near(service.encoder_getRPM()), "on-time speed");
+    check(group.group_getMissed() == 0, "no missed periods on time");
+
+    // Held just before the 6th target until past the 7th
+    run(start + 6 * kPeriodUs - 1);
+    sim::stallUs(kPeriodUs + 11);
+    for (; next <= sim::nowUs(); next += kEdgeUs) {
+        gen.step(1);                    // The wheel kept turning
+    }
+    sim::advanceUs(0);                  // Late alarm
+    printf("late: %.1f RPM, %u missed\n", service.encoder_getRPM(), group.group_getMissed());
+    check(group.group_getMissed() == 1, "skipped period counted");
+    check(near(service.encoder_getRPM()), "sample over two periods reads the true speed");
+
+    run(sim::nowUs() + 3 * kPeriodUs);
+    check(near(service.encoder_getRPM()), "speed after recovery");
+    check(std::fabs(service.encoder_getRotations() - gen.position() / (float)ENCODER_CPR) < 0.02f,
+          "rotations follow the ticks");
+
+    return test_result();
+}
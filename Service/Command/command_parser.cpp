@@ -0,0 +1,173 @@
+/***************************************************************
+ *  File: command_parser.cpp
+ *  Layer: Service Layer
+ *  Description:
+ *      - Incremental parser of the runtime command protocol.
+ *      - Numbers are parsed by hand: newlib's strtof may allocate.
+ ****************************************************************/
+
+#include "Command/command_parser.hpp"
+#include <float.h>
+
+// ---------------------------
+// Helpers
+// ---------------------------
+static inline const char* skipSpaces(const char* p) {
+    while (*p == ' ' || *p == '\t' || *p == ',') p++;
+    return p;
+}
+
+// Decimal number with optional sign, fraction and exponent.
+// The exponent saturates at 99, already past the float range, so
+// scaling stays bounded; results that overflow to inf are rejected.
+static bool parseNumber(const char*& p, float& out) {
+    p = skipSpaces(p);
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') {
+        negative = (*p == '-');
+        p++;
+    }
+
+    float value = 0.0f;
+    bool digits = false;
+    while (*p >= '0' && *p <= '9') {
+        value = value * 10.0f + (*p++ - '0');
+        digits = true;
+    }
+    if (*p == '.') {
+        p++;
+        float scale = 0.1f;
+        while (*p >= '0' && *p <= '9') {
+            value += (*p++ - '0') * scale;
+            scale *= 0.1f;
+            digits = true;
+        }
+    }
+    if (!digits) {
+        return false;
+    }
+    if (*p == 'e' || *p == 'E') {
+        p++;
+        bool negExp = (*p == '-');
+        if (*p == '-' || *p == '+') p++;
+        int exp = 0;
+        while (*p >= '0' && *p <= '9') {
+            exp = exp * 10 + (*p++ - '0');
+            if (exp > 99) exp = 99;
+        }
+        while (exp-- > 0) value = negExp ? value * 0.1f : value * 10.0f;
+    }
+    if (!(value <= FLT_MAX)) {
+        return false;
+    }
+
+    out = negative ? -value : value;
+    return (*p == '\0' || *p == ' ' || *p == '\t' || *p == ',');
+}
+
+// ---------------------------
+// Constructor
+// ---------------------------
+CommandParser::CommandParser()
+    : _length(0), _overflow(false), _head(0), _count(0), _dropped(0) {}
+
+// ---------------------------
+// Method: cmd_feed
+// ---------------------------
+bool CommandParser::cmd_feed(char c) {
+    if (c == '\n' || c == '\r') {
+        bool complete = (_length > 0 || _overflow);
+        if (_overflow) {
+            Command bad = {CommandType::INVALID, 0, {0.0f, 0.0f, 0.0f, 0.0f}};
+            push(bad);
+        } else if (_length > 0) {
+            _line[_length] = '\0';
+            parseLine();
+        }
+        _length = 0;
+        _overflow = false;
+        return complete;
+    }
+
+    if (_length < COMMAND_LINE_MAX) {
+        _line[_length++] = c;
+    } else {
+        _overflow = true;
+    }
+    return false;
+}
+
+// ---------------------------
+// Method: parseLine
+// ---------------------------
+void CommandParser::parseLine() {
+    Command cmd = {CommandType::INVALID, 0, {0.0f, 0.0f, 0.0f, 0.0f}};
+    const char* p = skipSpaces(_line);
+    char op = *p;
+    if (op >= 'a' && op <= 'z') op -= 'a' - 'A';
+    if (op != '\0') p++;
+
+    int needed;     // Numbers after the command letter, index included
+    switch (op) {
+        case 'S': cmd.type = CommandType::SET_SPEED;        needed = 2; break;
+        case 'G': cmd.type = CommandType::SET_GAINS;        needed = 4; break;
+        case 'T': cmd.type = CommandType::TELEMETRY;        needed = 1; break;
+        case 'Q': cmd.type = CommandType::QUERY;            needed = 1; break;
+        case 'D': cmd.type = CommandType::DUMP_TRACE;       needed = 0; break;
+        case 'C': cmd.type = CommandType::SET_CALIBRATION;  needed = 4; break;
+        case 'W': cmd.type = CommandType::SAVE_PARAMS;      needed = 0; break;
+        case 'F': cmd.type = CommandType::CLEAR_FAULT;      needed = 1; break;
+        default:  needed = -1; break;
+    }
+
+    float values[COMMAND_MAX_ARGS + 1] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    int n = 0;
+    while (needed >= 0 && *skipSpaces(p) != '\0') {
+        if (n > COMMAND_MAX_ARGS || !parseNumber(p, values[n])) {
+            needed = -1;
+            break;
+        }
+        n++;
+    }
+
+    // T takes an optional period
+    bool countOk = (n == needed) || (cmd.type == CommandType::TELEMETRY && n == 2);
+    if (needed < 0 || !countOk || values[0] < 0.0f || values[0] > 255.0f) {
+        cmd.type = CommandType::INVALID;
+    } else {
+        cmd.index = static_cast<uint8_t>(values[0]);
+        for (int i = 1; i < n; i++) {
+            cmd.args[i - 1] = values[i];
+        }
+    }
+
+    push(cmd);
+}
+
+// ---------------------------
+// Method: push
+// ---------------------------
+void CommandParser::push(const Command& cmd) {
+    if (_count == COMMAND_QUEUE_DEPTH) {
+        _dropped++;
+        return;
+    }
+    _queue[(_head + _count) % COMMAND_QUEUE_DEPTH] = cmd;
+    _count++;
+}
+
+// ---------------------------
+// Method: cmd_pop
+// ---------------------------
+bool CommandParser::cmd_pop(Command& out) {
+    if (_count == 0) {
+        return false;
+    }
+    out = _queue[_head];
+    _head = (_head + 1) % COMMAND_QUEUE_DEPTH;
+    _count--;
+    return true;
+}
+
+uint32_t CommandParser::cmd_getDropped() const { return _dropped; }
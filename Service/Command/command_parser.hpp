@@ -0,0 +1,122 @@
+#ifndef COMMAND_PARSER_HPP
+#define COMMAND_PARSER_HPP
+
+#include <stdint.h>
+
+/***************************************************************
+ * Command Protocol
+ * Description:
+ *     - One ASCII command per line, '\n' or '\r' terminated,
+ *       fields separated by spaces:
+ *         S <motor> <rpm>             set speed (sign = direction)
+ *         G <motor> <kp> <ki> <kd>    set PID gains
+ *         T <0|1> [every]             telemetry off/on, every N samples
+ *         Q <encoder>                 query EncoderService snapshot
+ *         D                           dump the edge trace
+ *         C <encoder> <cpr> <radius> <inverted>
+ *                                     set encoder calibration
+ *         W                           save parameters to flash
+ *                                     (motor stopped while it runs)
+ *         F <motor>                   clear a latched motor fault
+ *     - Indices are 0-based. Invalid lines become
+ *       CommandType::INVALID so the caller can reply to them.
+ *     - Numbers are always finite; value ranges are checked by
+ *       the caller when the command is applied.
+ ****************************************************************/
+#define COMMAND_LINE_MAX     48     // Longest accepted line
+#define COMMAND_QUEUE_DEPTH  8      // Parsed commands waiting for a tick
+#define COMMAND_RX_BUDGET    64     // Characters read per poll
+#define COMMAND_MAX_ARGS     4
+
+/***************************************************************
+ * Enum: CommandType
+ ****************************************************************/
+enum class CommandType : uint8_t {
+    INVALID,
+    SET_SPEED,
+    SET_GAINS,
+    TELEMETRY,
+    QUERY,
+    DUMP_TRACE,
+    SET_CALIBRATION,
+    SAVE_PARAMS,
+    CLEAR_FAULT,
+};
+
+/***************************************************************
+ * Struct: Command
+ * Description:
+ *     - A parsed command; fixed size, copied by value.
+ ****************************************************************/
+struct Command {
+    CommandType type;
+    uint8_t index;                      // Motor or encoder index
+    float args[COMMAND_MAX_ARGS];       // Numeric arguments after the index
+};
+
+/***************************************************************
+ * Class: CommandParser
+ * Layer: Service Layer
+ * Description:
+ *     - Incremental, zero-allocation line parser. Characters are
+ *       fed as they arrive; complete commands are queued until
+ *       the control loop applies them at a tick boundary.
+ *     - Never blocks: feeding and popping are O(line length).
+ *     - cmd_feed/cmd_pop are plain C++; cmd_pollStdio reads from
+ *       the Pico stdio without waiting.
+ ****************************************************************/
+class CommandParser {
+public:
+    /***********************************************************
+     * Constructor: CommandParser
+     ***********************************************************/
+    CommandParser();
+
+    /***********************************************************
+     * Method: cmd_feed
+     * Parameters:
+     *     - c: next received character
+     * Description:
+     *     - Returns true when c completed a line.
+     ***********************************************************/
+    bool cmd_feed(char c);
+
+    /***********************************************************
+     * Method: cmd_pollStdio
+     * Parameters:
+     *     - budget: maximum characters to read
+     * Description:
+     *     - Feeds characters already received on stdio, without
+     *       waiting. Returns the number of characters read.
+     ***********************************************************/
+    uint32_t cmd_pollStdio(uint32_t budget = COMMAND_RX_BUDGET);
+
+    /***********************************************************
+     * Method: cmd_pop
+     * Description:
+     *     - Takes the oldest parsed command. Returns false when
+     *       none is waiting.
+     ***********************************************************/
+    bool cmd_pop(Command& out);
+
+    /***********************************************************
+     * Method: cmd_getDropped
+     * Description:
+     *     - Returns commands lost because the queue was full.
+     ***********************************************************/
+    uint32_t cmd_getDropped() const;
+
+private:
+    void parseLine();
+    void push(const Command& cmd);
+
+    char _line[COMMAND_LINE_MAX + 1];   // Current line
+    uint8_t _length;                    // Characters in _line
+    bool _overflow;                     // Line too long, skip to end
+    Command _queue[COMMAND_QUEUE_DEPTH];
+    uint8_t _head;                      // Next command to pop
+    uint8_t _count;                     // Commands queued
+    uint32_t _dropped;                  // Queue-full losses
+};
+
+#endif
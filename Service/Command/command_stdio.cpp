@@ -0,0 +1,28 @@
+/***************************************************************
+ *  File: command_stdio.cpp
+ *  Layer: Service Layer
+ *  Description:
+ *      - Non-blocking stdio (USB/UART) input for CommandParser.
+ ****************************************************************/
+
+#include "pico/stdlib.h"
+#include "Command/command_parser.hpp"
+
+// ---------------------------
+// Method: cmd_pollStdio
+// ---------------------------
+// Description:
+//     - getchar_timeout_us(0) returns at once when nothing is
+//       buffered; the budget bounds the time spent per call.
+uint32_t CommandParser::cmd_pollStdio(uint32_t budget) {
+    uint32_t read = 0;
+    while (read < budget) {
+        int c = getchar_timeout_us(0);
+        if (c == PICO_ERROR_TIMEOUT) {
+            break;
+        }
+        cmd_feed(static_cast<char>(c));
+        read++;
+    }
+    return read;
+}
@@ -0,0 +1,116 @@
+/***************************************************************
+ *  File: encoder_sampling_group.cpp
+ *  Layer: Service Layer
+ *  Description:
+ *      - One hardware alarm samples every member EncoderService
+ *        in a single pass, replacing N repeating timers at
+ *        unrelated phases with one timer IRQ per period.
+ ****************************************************************/
+
+#include "Encoder/encoder_sampling_group.hpp"
+#include "Encoder/sample_event.hpp"
+#include "Profiler/cpu_profiler.hpp"
+#include "hardware/sync.h"
+
+// ---------------------------
+// Static members
+// ---------------------------
+EncoderSamplingGroup* EncoderSamplingGroup::groups[4] = {nullptr, nullptr, nullptr, nullptr};
+
+// ---------------------------
+// Constructor
+// ---------------------------
+EncoderSamplingGroup::EncoderSamplingGroup()
+    : _count(0), _alarm(-1), _periodUs(0), _target(0),
+      _sampleUs(0), _missed(0) {}
+
+// ---------------------------
+// Method: group_add
+// ---------------------------
+bool EncoderSamplingGroup::group_add(EncoderService& service) {
+    if (_count >= ENCODER_MAX_INSTANCES || _alarm >= 0) {
+        return false;
+    }
+    _services[_count++] = &service;
+    return true;
+}
+
+// ---------------------------
+// Method: group_start
+// ---------------------------
+// Description:
+//     - The first sample is taken one period after start.
+//     - The services convert deltas with ENCODER_SAMPLE_PERIOD_MS;
+//       any other period would scale every reading wrongly.
+bool EncoderSamplingGroup::group_start(uint32_t periodUs) {
+    if (periodUs != ENCODER_SAMPLE_PERIOD_MS * 1000u || _alarm >= 0) {
+        return false;
+    }
+    _periodUs = periodUs;
+    _alarm = hardware_alarm_claim_unused(true);
+    groups[_alarm] = this;
+
+    // Services measure from the current tick count
+    for (int i = 0; i < _count; i++) {
+        _services[i]->_lastTicks = _services[i]->_encoder.encoder_getTicks();
+    }
+
+    hardware_alarm_set_callback(_alarm, &EncoderSamplingGroup::alarmCallback);
+    _target = delayed_by_us(get_absolute_time(), _periodUs);
+    hardware_alarm_set_target(_alarm, _target);
+    return true;
+}
+
+// ---------------------------
+// Static alarm callback
+// ---------------------------
+void EncoderSamplingGroup::alarmCallback(uint alarm_num) {
+    PROFILE_ZONE(TIMER_CALLBACK);
+    groups[alarm_num]->onAlarm();
+}
+
+// ---------------------------
+// Method: onAlarm
+// ---------------------------
+// Description:
+//     - Ticks are latched with interrupts off, so no encoder IRQ
+//       can land between two members' reads.
+//     - Conversion to RPM/speed/distance runs after the alarm is
+//       re-armed, outside the critical section.
+//     - A latch too late for the next target stands in for the
+//       skipped ones: its delta spans 1 + skipped periods.
+//     - SampleEvent is published once all members are updated.
+void EncoderSamplingGroup::onAlarm() {
+    int32_t ticks[ENCODER_MAX_INSTANCES];
+
+    uint32_t irq = save_and_disable_interrupts();
+    for (int i = 0; i < _count; i++) {
+        ticks[i] = _services[i]->_encoder.encoder_getTicks();
+    }
+    _sampleUs = time_us_32();
+    restore_interrupts(irq);
+
+    // Next target from the previous one: no drift. A target already
+    // in the past is skipped rather than fired late.
+    uint32_t periods = 1;
+    _target = delayed_by_us(_target, _periodUs);
+    while (hardware_alarm_set_target(_alarm, _target)) {
+        _target = delayed_by_us(_target, _periodUs);
+        _missed++;
+        periods++;
+    }
+
+    for (int i = 0; i < _count; i++) {
+        _services[i]->sample(ticks[i], periods);
+    }
+
+    // One notification for the whole batch
+    SampleEvent::event_publish();
+}
+
+// ---------------------------
+// Getter Methods
+// ---------------------------
+uint32_t EncoderSamplingGroup::group_getSampleTimeUs() const { return _sampleUs; }
+
+uint32_t EncoderSamplingGroup::group_getMissed() const { return _missed; }
@@ -0,0 +1,94 @@
+#ifndef ENCODER_SAMPLING_GROUP_HPP
+#define ENCODER_SAMPLING_GROUP_HPP
+
+#include "Encoder/encoder_service.hpp"
+#include "hardware/timer.h"
+
+/***************************************************************
+ * Class: EncoderSamplingGroup
+ * Layer: Service Layer
+ * Description:
+ *     - Samples several EncoderService instances from one
+ *       hardware alarm instead of one repeating timer each.
+ *     - Every period the alarm IRQ latches all member tick counts
+ *       back-to-back with interrupts off, so all wheels are
+ *       sampled at the same instant, then updates the services.
+ *     - The alarm is re-armed from its previous target, so the
+ *       period does not drift with callback latency.
+ *     - Publishes one SampleEvent per period for all members.
+ ****************************************************************/
+class EncoderSamplingGroup {
+public:
+    /***********************************************************
+     * Constructor: EncoderSamplingGroup
+     * Description:
+     *     - Creates an empty group.
+     ***********************************************************/
+    EncoderSamplingGroup();
+
+    /***********************************************************
+     * Method: group_add
+     * Parameters:
+     *     - service: service to sample; do not also call its
+     *       encoder_start()
+     * Description:
+     *     - Returns false when the group is full or running.
+     ***********************************************************/
+    bool group_add(EncoderService& service);
+
+    /***********************************************************
+     * Method: group_start
+     * Parameters:
+     *     - periodUs: sample period, must match the period the
+     *       services convert with (ENCODER_SAMPLE_PERIOD_MS)
+     * Description:
+     *     - Claims an unused hardware alarm and starts sampling.
+     *     - Returns false, without starting, for any other period.
+     ***********************************************************/
+    bool group_start(uint32_t periodUs = ENCODER_SAMPLE_PERIOD_MS * 1000u);
+
+    /***********************************************************
+     * Method: group_getSampleTimeUs
+     * Description:
+     *     - Returns time_us_32() at which the last set of ticks
+     *       was latched.
+     ***********************************************************/
+    uint32_t group_getSampleTimeUs() const;
+
+    /***********************************************************
+     * Method: group_getMissed
+     * Description:
+     *     - Returns the number of periods skipped because the
+     *       alarm could not be re-armed in time. The sample after
+     *       a skip spans several periods and is scaled by them.
+     ***********************************************************/
+    uint32_t group_getMissed() const;
+
+private:
+    /***********************************************************
+     * Static Alarm Callback: alarmCallback
+     * Description:
+     *     - Dispatches the hardware alarm to its group.
+     ***********************************************************/
+    static void alarmCallback(uint alarm_num);
+
+    /***********************************************************
+     * Method: onAlarm
+     * Description:
+     *     - Latches all ticks, re-arms the alarm and updates
+     *       every member service.
+     ***********************************************************/
+    void onAlarm();
+
+    EncoderService* _services[ENCODER_MAX_INSTANCES];   // Members
+    int _count;                             // Number of members
+    int _alarm;                             // Claimed hardware alarm, -1 before start
+    uint32_t _periodUs;                     // Sample period
+    absolute_time_t _target;                // Current alarm target
+    volatile uint32_t _sampleUs;            // Time of last latch
+    volatile uint32_t _missed;              // Skipped periods
+
+    static EncoderSamplingGroup* groups[4]; // Group per hardware alarm
+};
+
+#endif
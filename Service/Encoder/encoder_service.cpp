@@ -4,11 +4,15 @@
  *  Description:
  *      - Converts raw encoder ticks from HAL into meaningful physical
  *        values such as RPM, linear speed (cm/s), distance traveled, and rotations.
- *      - Uses a periodic timer (100ms interval) to continuously update these values.
+ *      - Uses a periodic timer (ENCODER_SAMPLE_PERIOD_MS) to continuously update these
+ *        values, or is sampled together with other services by an EncoderSamplingGroup.
  *      - Provides a higher-level API for application layer access.
  ****************************************************************/
 
 #include "Encoder/encoder_service.hpp"
+#include "Encoder/sample_event.hpp"
+#include "Profiler/cpu_profiler.hpp"
+#include "hardware/sync.h"
 #include <cmath>
 
 // ---------------------------
@@ -17,22 +21,47 @@
 // Initializes the service layer object.
 // - Takes reference to EncoderHAL object (dependency injection).
 // - Initializes internal variables for tick counting, RPM, speed, distance.
+// - Calibration starts from the ENCODER_CPR/WHEEL_RADIUS_CM defaults.
 EncoderService::EncoderService(EncoderHAL& encoder)
     : _encoder(encoder),
       _lastTicks(0), _currentTicks(0),
-      _rpm(0), _speedCmS(0), _distanceCm(0){}
+      _rpm(0), _speedCmS(0), _distanceCm(0) {
+    encoder_setCalibration(ENCODER_CPR, WHEEL_RADIUS_CM, false);
+}
+
+// ---------------------------
+// Method: encoder_setCalibration
+// ---------------------------
+// Description:
+//     - Precomputes per-tick factors so sample() needs no division.
+//     - Updated with interrupts off: sample() runs in the timer IRQ.
+void EncoderService::encoder_setCalibration(uint32_t cpr, float wheelRadiusCm, bool inverted) {
+    if (cpr == 0) {
+        return;
+    }
+    int32_t sign = inverted ? -1 : 1;
+    float rotPerTick = 1.0f / static_cast<float>(cpr);
+
+    uint32_t irq = save_and_disable_interrupts();
+    _sign = sign;
+    _rpmPerTick = rotPerTick * (60000.0f / ENCODER_SAMPLE_PERIOD_MS);
+    _cmPerTick = rotPerTick * 2.0f * 3.1415926f * wheelRadiusCm;
+    _rotPerTick = sign * rotPerTick;
+    restore_interrupts(irq);
+}
 
 // ---------------------------
 // Method: encoder_start
 // ---------------------------
 // Description:
-//     - Starts a repeating timer with 100ms period.
+//     - Starts a repeating timer with ENCODER_SAMPLE_PERIOD_MS period.
 //     - Timer periodically calls static timerCallback function, which
 //       in turn updates RPM, speed, distance, and rotations.
 // Notes:
 //     - Uses pico-sdk's add_repeating_timer_ms API for scheduling periodic updates.
+//     - Not needed when the service is a member of an EncoderSamplingGroup.
 void EncoderService::encoder_start() {
-    add_repeating_timer_ms(100, EncoderService::timerCallback, this, &_timer);
+    add_repeating_timer_ms(-ENCODER_SAMPLE_PERIOD_MS, EncoderService::timerCallback, this, &_timer);
 }
 
 // ---------------------------
@@ -41,10 +70,13 @@ void EncoderService::encoder_start() {
 // Description:
 //     - Static method required by pico-sdk timer API.
 //     - Casts user_data pointer to EncoderService* and calls update().
+//     - Publishes SampleEvent so a waiting loop wakes up.
 //     - Returns true to keep the timer repeating.
 bool EncoderService::timerCallback(struct repeating_timer* t) {
     EncoderService* service = static_cast<EncoderService*>(t->user_data);
+    PROFILE_ZONE(TIMER_CALLBACK);
     service->update();
+    SampleEvent::event_publish();
     return true;
 }
 
@@ -52,25 +84,37 @@ bool EncoderService::timerCallback(struct repeating_timer* t) {
 // Method: update
 // ---------------------------
 // Description:
-//     - Reads current tick count from HAL.
-//     - Calculates change in ticks since last update.
+//     - Reads current tick count from HAL and processes it.
+void EncoderService::update() {
+    sample(_encoder.encoder_getTicks());
+}
+
+// ---------------------------
+// Method: sample
+// ---------------------------
+// Description:
+//     - Calculates change in ticks since last update, in the
+//       wheel's forward direction.
 //     - Converts ticks into physical values:
 //         1. RPM: Revolutions per minute
 //         2. Distance (cm) traveled based on wheel radius and encoder CPR
-//         3. Linear speed (cm/s) based on distance traveled over 100ms
+//         3. Linear speed (cm/s) based on distance traveled over the
+//            periods since the last sample (one, unless some were skipped)
 //     - Updates lastTicks for next iteration.
-void EncoderService::update() {
-    _currentTicks = _encoder.encoder_getTicks();
-    int32_t delta = _currentTicks - _lastTicks;
+void EncoderService::sample(int32_t ticks, uint32_t periods) {
+    _currentTicks = ticks;
+    int32_t delta = (_currentTicks - _lastTicks) * _sign;
+    float perPeriod = (periods > 1) ? 1.0f / periods : 1.0f;
 
-    // RPM calculation: delta ticks over 0.1s interval -> RPM
-    _rpm = (delta * 600.0f) / ENCODER_CPR;
+    // RPM calculation: delta ticks per sample period -> RPM
+    _rpm = delta * _rpmPerTick * perPeriod;
 
     // Distance calculation in cm
-    _distanceCm += (delta / static_cast<float>(ENCODER_CPR)) * 2.0f * 3.1415926f * WHEEL_RADIUS_CM;
+    float travelCm = delta * _cmPerTick;
+    _distanceCm += travelCm;
 
-    // Linear speed calculation in cm/s over 100ms
-    _speedCmS = (delta / static_cast<float>(ENCODER_CPR)) * 2.0f * 3.1415926f * WHEEL_RADIUS_CM / 0.1f;
+    // Linear speed calculation in cm/s per sample period
+    _speedCmS = travelCm * perPeriod * (1000.0f / ENCODER_SAMPLE_PERIOD_MS);
 
     _lastTicks = _currentTicks;
 }
@@ -86,4 +130,4 @@ float EncoderService::encoder_getSpeedCmS() const { return _speedCmS; }
 float EncoderService::encoder_getDistanceCm() const { return _distanceCm; }
 
 // Returns total number of rotations calculated from ticks
-float EncoderService::encoder_getRotations() const { return _currentTicks / static_cast<float>(ENCODER_CPR); }
+float EncoderService::encoder_getRotations() const { return _currentTicks * _rotPerTick; }
@@ -11,7 +11,8 @@
  * Description:
  *     - Provides high-level interface to compute physical metrics
  *       from raw encoder ticks: RPM, linear speed, distance, rotations.
- *     - Runs a repeating timer (100ms) to update these metrics automatically.
+ *     - Runs a repeating timer (ENCODER_SAMPLE_PERIOD_MS) to update these
+ *       metrics automatically, or is driven by an EncoderSamplingGroup.
  *     - Uses composition: holds a reference to HAL object.
  ****************************************************************/
 
@@ -29,11 +30,26 @@ public:
     /***********************************************************
      * Method: encoder_start
      * Description:
-     *     - Starts a periodic repeating timer (every 100ms) that updates
+     *     - Starts a periodic repeating timer (ENCODER_SAMPLE_PERIOD_MS) that updates
      *       the RPM, speed, distance, and rotations values.
      ***********************************************************/
     void encoder_start();
 
+    /***********************************************************
+     * Method: encoder_setCalibration
+     * Parameters:
+     *     - cpr: counts per wheel revolution (x4 decoded)
+     *     - wheelRadiusCm: wheel radius in cm
+     *     - inverted: true when the encoder counts backwards for
+     *       forward wheel motion
+     * Description:
+     *     - Replaces the compile-time ENCODER_CPR/WHEEL_RADIUS_CM
+     *       defaults, e.g. with values loaded from flash.
+     *     - Takes effect from the next sample; accumulated
+     *       distance is kept.
+     ***********************************************************/
+    void encoder_setCalibration(uint32_t cpr, float wheelRadiusCm, bool inverted);
+
     /***********************************************************
      * Method: encoder_getRPM
      * Description:
@@ -70,7 +86,7 @@ private:
     /***********************************************************
      * Static Timer Callback: timerCallback
      * Description:
-     *     - Called by hardware repeating timer every 100ms.
+     *     - Called by hardware repeating timer every ENCODER_SAMPLE_PERIOD_MS.
      *     - Delegates update to actual object instance using user_data pointer.
      ***********************************************************/
     static bool timerCallback(struct repeating_timer* t);
@@ -84,12 +100,30 @@ private:
      ***********************************************************/
     void update();
 
+    /***********************************************************
+     * Method: sample
+     * Parameters:
+     *     - ticks: tick count latched for this period
+     *     - periods: sample periods since the previous latch
+     * Description:
+     *     - Same as update(), for a tick count latched by the
+     *       caller (EncoderSamplingGroup). After skipped periods
+     *       the delta is averaged over all of them.
+     ***********************************************************/
+    void sample(int32_t ticks, uint32_t periods = 1);
+
+    friend class EncoderSamplingGroup;     // Latches ticks and calls sample()
+
     EncoderHAL& _encoder;                  // Reference to HAL object
     int32_t _lastTicks;                    // Tick count from previous timer cycle
     int32_t _currentTicks;                 // Tick count for current timer cycle
     float _rpm;                            // Computed RPM
     float _speedCmS;                       // Computed linear speed in cm/s
     float _distanceCm;                     // Computed total distance
+    int32_t _sign;                         // -1 when the encoder is inverted
+    float _rpmPerTick;                     // Tick delta per period -> RPM
+    float _cmPerTick;                      // Tick -> wheel travel in cm
+    float _rotPerTick;                     // Tick -> rotations, sign included
     struct repeating_timer _timer;         // Hardware timer structure
 };
 
@@ -0,0 +1,72 @@
+/***************************************************************
+ *  File: sample_event.cpp
+ *  Layer: Service Layer
+ *  Description:
+ *      - SEV/WFE based notification of new encoder samples.
+ ****************************************************************/
+
+#include "Encoder/sample_event.hpp"
+#include "Profiler/cpu_profiler.hpp"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+// ---------------------------
+// Static members
+// ---------------------------
+volatile uint32_t SampleEvent::sequence = 0;
+volatile uint32_t SampleEvent::publishUs = 0;
+SampleWakeStats SampleEvent::stats = {0, 0, 0, UINT32_MAX, 0, 0};
+
+// ---------------------------
+// Method: event_publish
+// ---------------------------
+// Description:
+//     - The timestamp is written before the sequence, and the
+//       barrier orders both before SEV, so a woken reader always
+//       sees the matching time.
+void SampleEvent::event_publish() {
+    publishUs = time_us_32();
+    __dmb();
+    sequence = sequence + 1;
+    __dmb();
+    __sev();
+}
+
+uint32_t SampleEvent::event_getSequence() { return sequence; }
+
+// ---------------------------
+// Method: event_wait
+// ---------------------------
+// Description:
+//     - A publish between the check and WFE leaves the event
+//       register set, so WFE returns at once and nothing is lost.
+uint32_t SampleEvent::event_wait(uint32_t& seq) {
+    uint32_t now;
+    PROFILE_ENTER(IDLE);
+    while ((now = sequence) == seq) {
+        __wfe();
+        stats.wakeups++;
+    }
+    PROFILE_EXIT();
+
+    uint32_t latency = time_us_32() - publishUs;
+    uint32_t fresh = now - seq;
+    seq = now;
+
+    stats.samples++;
+    stats.missed += fresh - 1;
+    stats.totalLatencyUs += latency;
+    if (latency < stats.minLatencyUs) stats.minLatencyUs = latency;
+    if (latency > stats.maxLatencyUs) stats.maxLatencyUs = latency;
+
+    return fresh;
+}
+
+// ---------------------------
+// Statistics
+// ---------------------------
+SampleWakeStats SampleEvent::event_getStats() { return stats; }
+
+void SampleEvent::event_resetStats() {
+    stats = SampleWakeStats{0, 0, 0, UINT32_MAX, 0, 0};
+}
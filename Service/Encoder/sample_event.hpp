@@ -0,0 +1,74 @@
+#ifndef SAMPLE_EVENT_HPP
+#define SAMPLE_EVENT_HPP
+
+#include <stdint.h>
+
+/***************************************************************
+ * Struct: SampleWakeStats
+ * Description:
+ *     - Latency from a published sample to the waiting loop
+ *       running again, and how often the loop woke up.
+ ****************************************************************/
+struct SampleWakeStats {
+    uint32_t samples;           // Samples received by event_wait
+    uint32_t missed;            // Samples published while not waiting
+    uint32_t wakeups;           // WFE returns, including spurious ones
+    uint32_t minLatencyUs;      // Fastest publish-to-wake
+    uint32_t maxLatencyUs;      // Slowest publish-to-wake
+    uint64_t totalLatencyUs;    // Sum, for the average
+};
+
+/***************************************************************
+ * Class: SampleEvent
+ * Layer: Service Layer
+ * Description:
+ *     - "New sample ready" notification from the sampling IRQ to
+ *       the application loop.
+ *     - Publishing bumps a sequence number and executes SEV;
+ *       the waiting loop sleeps in WFE until the sequence moves,
+ *       so it reacts within microseconds and does not wake on a
+ *       fixed sleep when nothing changed.
+ ****************************************************************/
+class SampleEvent {
+public:
+    /***********************************************************
+     * Static Method: event_publish
+     * Description:
+     *     - Marks a new sample as ready. Called from IRQ context
+     *       once all services have been updated.
+     ***********************************************************/
+    static void event_publish();
+
+    /***********************************************************
+     * Static Method: event_getSequence
+     * Description:
+     *     - Returns the number of samples published so far.
+     ***********************************************************/
+    static uint32_t event_getSequence();
+
+    /***********************************************************
+     * Static Method: event_wait
+     * Parameters:
+     *     - seq: last sequence seen; updated to the current one
+     * Description:
+     *     - Sleeps in WFE until a sample newer than seq exists.
+     *     - Returns the number of new samples (more than 1 means
+     *       the caller fell behind).
+     ***********************************************************/
+    static uint32_t event_wait(uint32_t& seq);
+
+    /***********************************************************
+     * Static Methods: event_getStats / event_resetStats
+     * Description:
+     *     - Wake-up latency statistics of event_wait.
+     ***********************************************************/
+    static SampleWakeStats event_getStats();
+    static void event_resetStats();
+
+private:
+    static volatile uint32_t sequence;      // Samples published
+    static volatile uint32_t publishUs;     // Time of last publish
+    static SampleWakeStats stats;           // Updated by event_wait only
+};
+
+#endif
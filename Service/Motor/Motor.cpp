@@ -1,7 +1,7 @@
 #include "Motor.hpp"
 
 Motor::Motor(HBridge& driver)
-    : _driver(driver) {}
+    : _driver(driver), _command(0.0f), _locked(false) {}
 
 void Motor::init() {
     _driver.init();
@@ -11,11 +11,16 @@ void Motor::setSpeed(float speed) {
     if (speed > 1.0f)  speed = 1.0f;
     if (speed < -1.0f) speed = -1.0f;
 
-    if (speed > 0) {
+    if (_locked) {
+        stop();
+    }
+    else if (speed > 0) {
         _driver.setMotor(MotorState::CW, speed);
+        _command = speed;
     } 
     else if (speed < 0) {
         _driver.setMotor(MotorState::CCW, -speed);
+        _command = speed;
     } 
     else {
         stop();
@@ -24,4 +29,18 @@ void Motor::setSpeed(float speed) {
 
 void Motor::stop() {
     _driver.setMotor(MotorState::STOP, 0);
+    _command = 0.0f;
+}
+
+float Motor::getCommand() const {
+    return _command;
+}
+
+void Motor::setLockout(bool locked) {
+    _locked = locked;
+    if (locked) stop();
+}
+
+bool Motor::isLockedOut() const {
+    return _locked;
 }
@@ -11,8 +11,14 @@ public:
     void setSpeed(float speed); // -1.0 >> +1.0
     void stop();
 
+    float getCommand() const;   // Last applied speed, -1.0 >> +1.0
+    void setLockout(bool locked); // Locked: setSpeed() keeps the motor stopped
+    bool isLockedOut() const;
+
 private:
     HBridge& _driver;
+    float _command;
+    bool _locked;
 };
 
 #endif
@@ -0,0 +1,158 @@
+/***************************************************************
+ *  File: motor_monitor.cpp
+ *  Layer: Service Layer
+ *  Description:
+ *      - Per-tick stall, runaway, reversed-wiring and
+ *        encoder-loss detection with immediate bridge cutoff.
+ ****************************************************************/
+
+#include "Motor/motor_monitor.hpp"
+#include "pico/stdlib.h"
+#include <math.h>
+
+// Consecutive-tick counter: advances while the condition holds
+static inline void holdCount(uint8_t& count, bool condition) {
+    if (!condition) {
+        count = 0;
+    } else if (count < UINT8_MAX) {
+        count++;
+    }
+}
+
+static inline bool held(uint8_t count, uint8_t ticks) {
+    return count >= (ticks ? ticks : 1);
+}
+
+// ---------------------------
+// Constructor
+// ---------------------------
+MotorMonitor::MotorMonitor(Motor& motor, HBridge& driver, EncoderHAL& encoder,
+                           EncoderService& service, const MonitorConfig& config)
+    : _motor(motor), _driver(driver), _encoder(encoder), _service(service),
+      _config(config), _fault(MotorFault::NONE), _tripTick(0), _tripUs(0) {
+    restart();
+}
+
+// ---------------------------
+// Method: restart
+// ---------------------------
+// Description:
+//     - Counters are taken as the new baseline, so activity from
+//       before a start or clear is never judged.
+void MotorMonitor::restart() {
+    _ticks = 0;
+    _lastTicks = _encoder.encoder_getTicks();
+    _lastEdges = _encoder.encoder_getEdgeCount();
+    _lastErrors = _encoder.encoder_getErrorCount();
+    _lastRpm = _service.encoder_getRPM();
+    _stallCount = 0;
+    _runawayCount = 0;
+    _reversedCount = 0;
+    _lossCount = 0;
+}
+
+// ---------------------------
+// Method: monitor_tick
+// ---------------------------
+// Description:
+//     - The duty read from the Motor is the one applied during
+//       the period the new sample measured.
+//     - Encoder loss: a driven wheel with one channel stuck still
+//       produces edges on the other, but they cancel (+1/-1), and
+//       the speed reads ~0. It is checked before stall, which
+//       is what a loss of both channels looks like.
+//     - Reversed: speed against the command that is not moving
+//       towards it; a commanded reversal decelerates by more than
+//       recoveryRpm per tick and is not flagged.
+//     - Runaway: faster than the duty can drive, and not slowing
+//       by recoveryRpm per tick; a wheel coasting down after the
+//       duty was cut is not flagged.
+bool MotorMonitor::monitor_tick() {
+    if (_fault != MotorFault::NONE) {
+        return false;
+    }
+    _ticks++;
+
+    int32_t ticks = _encoder.encoder_getTicks();
+    uint32_t edges = _encoder.encoder_getEdgeCount();
+    uint32_t errors = _encoder.encoder_getErrorCount();
+    uint32_t net = static_cast<uint32_t>(ticks >= _lastTicks ? ticks - _lastTicks : _lastTicks - ticks);
+    uint32_t activity = (edges - _lastEdges) + (errors - _lastErrors);
+    _lastTicks = ticks;
+    _lastEdges = edges;
+    _lastErrors = errors;
+
+    float rpm = _service.encoder_getRPM();
+    float duty = _motor.getCommand();
+    float dir = (duty >= 0.0f) ? 1.0f : -1.0f;
+    float along = rpm * dir;                    // Speed in the commanded direction
+    float progress = (rpm - _lastRpm) * dir;    // Change towards it this tick
+    float slowing = fabsf(_lastRpm) - fabsf(rpm);
+    _lastRpm = rpm;
+    float drivable = fabsf(duty) * _config.fullDutyRpm + _config.runawayMarginRpm;
+
+    bool driven = fabsf(duty) >= _config.minDuty;
+    bool loss = driven && activity >= _config.lossMinEdges && net * 4 < activity;
+
+    holdCount(_runawayCount, fabsf(rpm) > drivable && slowing < _config.recoveryRpm);
+    holdCount(_reversedCount, driven && along <= -_config.reversedRpm && progress < _config.recoveryRpm);
+    holdCount(_lossCount, loss);
+    holdCount(_stallCount, driven && !loss && fabsf(rpm) < _config.stallRpm);
+
+    if (held(_runawayCount, _config.runawayTicks)) {
+        trip(MotorFault::RUNAWAY);
+    } else if (held(_reversedCount, _config.reversedTicks)) {
+        trip(MotorFault::REVERSED);
+    } else if (held(_lossCount, _config.lossTicks)) {
+        trip(MotorFault::ENCODER_LOSS);
+    } else if (held(_stallCount, _config.stallTicks)) {
+        trip(MotorFault::STALL);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------
+// Method: trip
+// ---------------------------
+// Description:
+//     - The bridge is stopped first, before anything else runs;
+//       the lockout then keeps later setSpeed() calls from
+//       re-enabling it.
+void MotorMonitor::trip(MotorFault fault) {
+    _driver.setMotor(MotorState::STOP, 0);
+    _motor.setLockout(true);
+    _fault = fault;
+    _tripTick = _ticks;
+    _tripUs = time_us_32();
+}
+
+// ---------------------------
+// Method: monitor_clear
+// ---------------------------
+void MotorMonitor::monitor_clear() {
+    _fault = MotorFault::NONE;
+    _motor.setLockout(false);
+    restart();
+}
+
+// ---------------------------
+// Getter Methods
+// ---------------------------
+MotorFault MotorMonitor::monitor_getFault() const { return _fault; }
+
+uint32_t MotorMonitor::monitor_getTripTick() const { return _tripTick; }
+
+uint32_t MotorMonitor::monitor_getTripUs() const { return _tripUs; }
+
+const char* MotorMonitor::monitor_faultName(MotorFault fault) {
+    switch (fault) {
+        case MotorFault::NONE:          return "NONE";
+        case MotorFault::STALL:         return "STALL";
+        case MotorFault::RUNAWAY:       return "RUNAWAY";
+        case MotorFault::REVERSED:      return "REVERSED";
+        case MotorFault::ENCODER_LOSS:  return "ENCODER_LOSS";
+    }
+    return "?";
+}
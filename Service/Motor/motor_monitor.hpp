@@ -0,0 +1,150 @@
+#ifndef MOTOR_MONITOR_HPP
+#define MOTOR_MONITOR_HPP
+
+#include <stdint.h>
+#include "Motor/Motor.hpp"
+#include "H_Bridge/HBridge_hal.hpp"
+#include "Encoder/encoder_hal.hpp"
+#include "Encoder/encoder_service.hpp"
+#include "PID_config.hpp"
+
+/***************************************************************
+ * Supervisory Monitor Defaults
+ * Description:
+ *     - A fault trips after its condition held for this many
+ *       consecutive control ticks: detection latency is at most
+ *       MONITOR_TRIP_TICKS x ENCODER_SAMPLE_PERIOD_MS plus one
+ *       wake-up of the control loop.
+ *     - Stall, reversal and encoder-loss checks only run while
+ *       the commanded duty is at least MONITOR_MIN_DUTY, where a
+ *       healthy drive must move the wheel.
+ *     - Runaway: faster than the commanded duty can drive the
+ *       wheel (|duty| x MAX_RPM, the PID's full-throttle speed)
+ *       by more than MONITOR_RUNAWAY_MARGIN_RPM, and not slowing
+ *       towards it. A bridge stuck on, or a wheel driven
+ *       externally, at low or zero duty is caught well below
+ *       full speed.
+ *     - Speeds in RPM as reported by EncoderService.
+ ****************************************************************/
+#define MONITOR_TRIP_TICKS          3
+#define MONITOR_MIN_DUTY            0.3f
+#define MONITOR_STALL_RPM           15.0f               // Below: not turning
+#define MONITOR_RUNAWAY_MARGIN_RPM  (MAX_RPM * 0.25f)   // Above the speed the duty can drive
+#define MONITOR_REVERSED_RPM        15.0f               // Opposite to the command by at least
+#define MONITOR_RECOVERY_RPM        5.0f                // Per tick towards the command: a reversal
+#define MONITOR_LOSS_MIN_EDGES      8                   // Edges per tick to judge the net count
+
+/***************************************************************
+ * Enum: MotorFault
+ ****************************************************************/
+enum class MotorFault : uint8_t {
+    NONE,
+    STALL,          // Driven but not turning, or no encoder signal at all
+    RUNAWAY,        // Overspeed: driven externally or the bridge is stuck on
+    REVERSED,       // Turning against the command: motor or encoder wired backwards
+    ENCODER_LOSS,   // Edges without net count: one channel lost or noisy
+};
+
+/***************************************************************
+ * Struct: MonitorConfig
+ * Description:
+ *     - Thresholds and tick counts; defaults from the macros.
+ ****************************************************************/
+struct MonitorConfig {
+    uint8_t stallTicks = MONITOR_TRIP_TICKS;
+    uint8_t runawayTicks = MONITOR_TRIP_TICKS;
+    uint8_t reversedTicks = MONITOR_TRIP_TICKS;
+    uint8_t lossTicks = MONITOR_TRIP_TICKS;
+    float minDuty = MONITOR_MIN_DUTY;
+    float stallRpm = MONITOR_STALL_RPM;
+    float runawayMarginRpm = MONITOR_RUNAWAY_MARGIN_RPM;
+    float fullDutyRpm = MAX_RPM;                // Speed at |duty| = 1
+    float reversedRpm = MONITOR_REVERSED_RPM;
+    float recoveryRpm = MONITOR_RECOVERY_RPM;
+    uint32_t lossMinEdges = MONITOR_LOSS_MIN_EDGES;
+};
+
+/***************************************************************
+ * Class: MotorMonitor
+ * Layer: Service Layer
+ * Description:
+ *     - Supervises one motor and its encoder once per control
+ *       tick: the duty that Motor::setSpeed applied during the
+ *       last sample period is compared with the speed
+ *       EncoderService measured and the edge activity EncoderHAL
+ *       counted over the same period.
+ *     - On a fault the bridge is stopped from within that tick
+ *       (HBridge::setMotor(STOP)), the Motor is locked out and
+ *       the fault code is latched until monitor_clear().
+ *     - A tick is a few comparisons on counters already kept by
+ *       the HAL; nothing is added to the encoder ISR.
+ ****************************************************************/
+class MotorMonitor {
+public:
+    /***********************************************************
+     * Constructor: MotorMonitor
+     * Parameters:
+     *     - motor: supervised motor, locked out on a fault
+     *     - driver: its H-bridge, stopped directly on a fault
+     *     - encoder / service: the encoder on the same shaft
+     *     - config: thresholds and tick counts
+     ***********************************************************/
+    MotorMonitor(Motor& motor, HBridge& driver, EncoderHAL& encoder,
+                 EncoderService& service, const MonitorConfig& config = MonitorConfig());
+
+    /***********************************************************
+     * Method: monitor_tick
+     * Description:
+     *     - Call once per control tick, after the new encoder
+     *       sample and before the next Motor::setSpeed().
+     *     - Returns true when this tick latched a fault.
+     ***********************************************************/
+    bool monitor_tick();
+
+    /***********************************************************
+     * Method: monitor_clear
+     * Description:
+     *     - Releases the lockout and restarts every check. The
+     *       motor stays stopped until the next setSpeed().
+     ***********************************************************/
+    void monitor_clear();
+
+    /***********************************************************
+     * Getter Methods
+     * Description:
+     *     - monitor_getFault: latched fault, NONE when running.
+     *     - monitor_getTripTick: ticks from start or clear to the
+     *       tick that latched the fault.
+     *     - monitor_getTripUs: time_us_32() of the cutoff.
+     *     - monitor_faultName: short upper-case name for logs.
+     ***********************************************************/
+    MotorFault monitor_getFault() const;
+    uint32_t monitor_getTripTick() const;
+    uint32_t monitor_getTripUs() const;
+    static const char* monitor_faultName(MotorFault fault);
+
+private:
+    void trip(MotorFault fault);
+    void restart();
+
+    Motor& _motor;
+    HBridge& _driver;
+    EncoderHAL& _encoder;
+    EncoderService& _service;
+    MonitorConfig _config;
+
+    MotorFault _fault;              // Latched fault
+    uint32_t _ticks;                // Ticks since start or clear
+    uint32_t _tripTick;
+    uint32_t _tripUs;
+    int32_t _lastTicks;             // HAL counters at the previous tick
+    uint32_t _lastEdges;
+    uint32_t _lastErrors;
+    float _lastRpm;
+    uint8_t _stallCount;            // Consecutive ticks each condition held
+    uint8_t _runawayCount;
+    uint8_t _reversedCount;
+    uint8_t _lossCount;
+};
+
+#endif
@@ -1,84 +1,112 @@
 #include "PID.hpp"
 
-MotorPID::MotorPID(PIDINPUT * PIDIn):target_RPM_(PIDIn->expected_speed),
-                                    clock_wise_(true),
+/***************************************************************************************************************************************************** */
+static PIDConfig MotorPIDConfig(const MotorPID::PIDINPUT * PIDIn)
+{
+    PIDConfig cfg;
+    cfg.kp = PIDIn->kp;
+    cfg.ki = PIDIn->ki;
+    cfg.kd = PIDIn->kd;
+    cfg.dt = PIDIn->dt;
+    cfg.out_min = -MAX_RPM;
+    cfg.out_max = MAX_RPM;
+    cfg.d_filter_tau = PIDIn->d_filter_tau;
+    cfg.kaw = PIDIn->kaw;
+    cfg.slew_rate = PIDIn->slew_rate;
+    return cfg;
+}
+/***************************************************************************************************************************************************** */
+MotorPID::MotorPID(PIDINPUT * PIDIn):controller_(MotorPIDConfig(PIDIn)),
+                                    target_RPM_(PIDIn->expected_speed),
+                                    clock_wise_(PIDIn->expected_speed >= 0.0f),
                                     throttle_(0.0f),
-                                    dt_(PIDIn->dt),
-                                    kp_(PIDIn->kp),
-                                    ki_(PIDIn->ki),
-                                    kd_(PIDIn->kd),
-                                    error_(0.0f),
-                                    last_error_(0.0f),
-                                    error_sum_(0.0f)
+                                    kff_(PIDIn->kff),
+                                    schedule_variable_(ScheduleVariable::MEASURED_RPM),
+                                    direction_integrator_{0.0f, 0.0f}
 {
-    if(ki_!= 0.0f)
-    {
-        integral_max_ = MAX_RPM/ki_;
-        integral_min_ = -MAX_RPM/ki_;
-    }
-    else
-    {
-        integral_max_ = 0.0f;
-        integral_min_ = 0.0f;
-    }
 }
 /***************************************************************************************************************************************************** */
-void MotorPID::SetSpeedRPM(float rpm, bool cw)
+void MotorPID::SetSpeedRadPSec(float rps, bool cw)
 {
-    target_RPM_ = cw ? rpm : -rpm;
-    clock_wise_ = cw; 
-    throttle_ = clamp(target_RPM_/ MAX_RPM, -1.0f, 1.0f);
-    error_sum_  = 0.0;
+    SetSpeedRPM(rps * 60.0f / (2.0f * PI_value), cw);
 }
 /***************************************************************************************************************************************************** */
-MotorPID::PIDOutput MotorPID::ComputePID(float motor_speed)
+void MotorPID::SetSpeedRPM(float rpm, bool cw)
 {
-    PIDOutput PID_out;
+    const float target = cw ? rpm : -rpm;
 
-    error_ = target_RPM_- motor_speed;
-    error_sum_ += error_ * dt_;
-    error_sum_ = clamp(error_sum_, integral_min_, integral_max_);
+    // Stored before retarget() can touch it, restored after
+    float restore = 0.0f;
+    if (cw != clock_wise_)
+    {
+        direction_integrator_[clock_wise_ ? 1 : 0] = controller_.integrator();
+        restore = direction_integrator_[cw ? 1 : 0];
+    }
 
-    PID_out.p = error_ * kp_;
+    controller_.retarget(target - target_RPM_);
 
-    if(dt_ != 0.0f)
+    if (cw != clock_wise_)
     {
-        PID_out.d = kd_ * ( (error_ - last_error_) /dt_ );
+        controller_.loadIntegrator(restore);
     }
-    else
+
+    target_RPM_ = target;
+    clock_wise_ = cw;
+}
+/***************************************************************************************************************************************************** */
+void MotorPID::Reset()
+{
+    controller_.reset(0.0f, 0.0f);
+    target_RPM_ = 0.0f;
+    throttle_ = 0.0f;
+    direction_integrator_[0] = 0.0f;
+    direction_integrator_[1] = 0.0f;
+}
+/***************************************************************************************************************************************************** */
+void MotorPID::SetGains(float kp, float ki, float kd)
+{
+    schedule_.clear();
+    controller_.setGains(PIDGains{kp, ki, kd});
+}
+/***************************************************************************************************************************************************** */
+bool MotorPID::SetGainSchedule(ScheduleVariable variable, float rpm_min, float rpm_max,
+                               const PIDGains* points, uint8_t count)
+{
+    if (!schedule_.configure(rpm_min, rpm_max, points, count))
     {
-        PID_out.d = 0.0f;
+        return false;
     }
-    
-    PID_out.i = error_sum_ * ki_;
-    PID_out.total = (PID_out.d + PID_out.i + PID_out.p);
-
-    last_error_ = error_;
-
-    return(PID_out);
+    schedule_variable_ = variable;
+    return true;
 }
 /***************************************************************************************************************************************************** */
-float MotorPID::UpdateThrottle(float motor_speed)
+PIDGains MotorPID::GetGains() const
 {
-    
-    float pid_Process_result = (this->ComputePID(motor_speed)).total;
-
-    float delta = pid_Process_result / MAX_RPM ;
-    float t =  throttle_+ delta;
-
-    t = clamp(t,-1.0f,1.0f);
-    throttle_ = t;
-
-    return(t);
+    const PIDConfig& cfg = controller_.config();
+    return PIDGains{cfg.kp, cfg.ki, cfg.kd};
 }
 /***************************************************************************************************************************************************** */
-float MotorPID::clamp(float value, float min, float max) 
+MotorPID::PIDOutput MotorPID::ComputePID(float motor_speed)
 {
-    return (value > max) ? max : (value < min) ? min : value;
+    if (schedule_.enabled())
+    {
+        const float rpm = (schedule_variable_ == ScheduleVariable::MEASURED_RPM) ? motor_speed : target_RPM_;
+        controller_.setGains(schedule_.lookup(rpm));
+    }
+    controller_.step(target_RPM_, motor_speed, kff_ * target_RPM_);
+    return(controller_.terms());
+}
+/***************************************************************************************************************************************************** */
+float MotorPID::UpdateThrottle(float motor_speed)
+{
+    // Controller output is limited to ±MAX_RPM, so the throttle is within [-1, 1]
+    throttle_ = this->ComputePID(motor_speed).total / MAX_RPM;
+
+    return(throttle_);
 }
 /***************************************************************************************************************************************************** */
 MotorPID::~MotorPID()
 {
-    
+
 }
 /***************************************************************************************************************************************************** */
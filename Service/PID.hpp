@@ -4,23 +4,447 @@
 /******************************************* Include Part ******************************************** */
 /**
  * @file PID.hpp
- * @brief PID controller class for motor speed control.
- * 
- * This file defines the MotorPID class which implements a PID controller
- * for controlling motor speed in RPM. Supports configurable Kp, Ki, Kd,
- * and allows updating the throttle based on measured motor speed.
+ * @brief PID controller library for motor speed control.
+ *
+ * This file defines:
+ * - PIDController<Form>: a generic discrete PID step, specialised at compile
+ *   time for the positional or the incremental (velocity) form.
+ * - GainSchedule: gains interpolated against speed, O(1) per lookup.
+ * - MotorPID: the motor speed controller used by the application, built on
+ *   the form selected by PID_CONTROLLER_FORM in PID_config.hpp.
+ *
+ * Both forms share:
+ * - derivative on measurement with a first-order low-pass D filter
+ *   (no derivative kick on setpoint changes),
+ * - output clamping with back-calculation anti-windup,
+ * - output slew-rate limiting,
+ * - bumpless transfer on gain and setpoint changes.
  */
 #include <stdint.h>
+#include <type_traits>
+#include "PID_config.hpp"
+
+/**
+ * @struct PositionalPID
+ * @brief Form tag: output is recomputed every step, u = P + I + D + FF.
+ */
+struct PositionalPID {};
+
+/**
+ * @struct IncrementalPID
+ * @brief Form tag: only the change of output is computed, u += dP + dI + dD + dFF.
+ *
+ * The integrator lives in the output itself, so clamping the output is
+ * already a perfect anti-windup.
+ */
+struct IncrementalPID {};
+
+/**
+ * @struct PIDConfig
+ * @brief Tuning and limits of a PIDController.
+ */
+struct PIDConfig
+{
+    float kp;               /**< Proportional gain */
+    float ki;               /**< Integral gain [1/s] */
+    float kd;               /**< Derivative gain [s] */
+    float dt;               /**< Sample time [s] */
+    float out_min;          /**< Lower output limit */
+    float out_max;          /**< Upper output limit */
+    float d_filter_tau;     /**< D filter time constant [s], 0 = unfiltered */
+    float kaw;              /**< Back-calculation anti-windup gain [1/s], positional form only */
+    float slew_rate;        /**< Maximum output change per second, 0 = unlimited */
+};
+
+/**
+ * @struct PIDGains
+ * @brief One set of PID gains.
+ */
+struct PIDGains
+{
+    float kp;               /**< Proportional gain */
+    float ki;               /**< Integral gain [1/s] */
+    float kd;               /**< Derivative gain [s] */
+};
+
+/**
+ * @struct PIDOutput
+ * @brief Structure holding PID calculation results.
+ *
+ * For the incremental form p, i and d are the increments applied this step.
+ */
+typedef struct
+{
+    float p;             /**< Proportional component */
+    float i;             /**< Integral component */
+    float d;             /**< Derivative component */
+    float total;         /**< Controller output after clamping and slew limiting */
+}PIDOutput;
+
+/**
+ * @class PIDController
+ * @brief Discrete PID step specialised for a form tag.
+ *
+ * @tparam Form PositionalPID or IncrementalPID
+ */
+template <typename Form>
+class PIDController
+{
+    static_assert(std::is_same<Form, PositionalPID>::value ||
+                  std::is_same<Form, IncrementalPID>::value,
+                  "PIDController form must be PositionalPID or IncrementalPID");
+
+    public:
+
+        /**
+         * @brief Construct a new PIDController
+         *
+         * @param cfg Gains, sample time and limits
+         */
+        explicit PIDController(const PIDConfig& cfg) : cfg_(cfg)
+        {
+            configure(cfg);
+            reset(0.0f, 0.0f);
+        }
+
+        /**
+         * @brief Replace gains, sample time and limits without resetting state
+         *
+         * @param cfg New configuration
+         */
+        void configure(const PIDConfig& cfg)
+        {
+            cfg_ = cfg;
+            d_alpha_ = (cfg.d_filter_tau > 0.0f) ? cfg.d_filter_tau / (cfg.d_filter_tau + cfg.dt) : 0.0f;
+            inv_dt_ = (cfg.dt != 0.0f) ? 1.0f / cfg.dt : 0.0f;
+            max_step_ = cfg.slew_rate * cfg.dt;
+        }
+
+        /**
+         * @brief Restart the controller from a known output
+         *
+         * Clears the integrator and derivative history. The next step
+         * computes no derivative and, in the incremental form, no
+         * proportional jump.
+         *
+         * @param output Output to continue from
+         * @param feedforward Feedforward already contained in output
+         */
+        void reset(float output, float feedforward)
+        {
+            integral_ = 0.0f;
+            d_term_ = 0.0f;
+            last_measurement_ = 0.0f;
+            last_error_ = 0.0f;
+            last_feedforward_ = feedforward;
+            output_ = clamp(output, cfg_.out_min, cfg_.out_max);
+            pending_ = 0.0f;
+            primed_ = false;
+            terms_ = PIDOutput{0.0f, 0.0f, 0.0f, output_};
+        }
+
+        /**
+         * @brief Change gains without a step in the output
+         *
+         * The positional integrator absorbs the change of the P and D
+         * terms at the last error; the filtered D term is rescaled so
+         * the incremental form sees no D jump either.
+         *
+         * @param gains New gains
+         */
+        void setGains(const PIDGains& gains)
+        {
+            const float d_new = (cfg_.kd != 0.0f) ? d_term_ * (gains.kd / cfg_.kd) : 0.0f;
+            if constexpr (std::is_same<Form, PositionalPID>::value)
+            {
+                if (primed_)
+                {
+                    integral_ += (cfg_.kp - gains.kp) * last_error_ + (d_term_ - d_new);
+                }
+            }
+            d_term_ = d_new;
+            cfg_.kp = gains.kp;
+            cfg_.ki = gains.ki;
+            cfg_.kd = gains.kd;
+        }
+
+        /**
+         * @brief Move the setpoint without a proportional kick
+         *
+         * The output continues from its current value and the new
+         * error is worked off by the integral action.
+         *
+         * @param delta New setpoint minus old setpoint
+         */
+        void retarget(float delta)
+        {
+            if (!primed_)
+            {
+                return;
+            }
+            if constexpr (std::is_same<Form, PositionalPID>::value)
+            {
+                integral_ -= cfg_.kp * delta;
+            }
+            else
+            {
+                last_error_ += delta;
+            }
+        }
+
+        /**
+         * @brief Integrated part of the output
+         *
+         * The integral term in the positional form; in the incremental
+         * form the output without its feedforward, including any part
+         * of a loaded value still being ramped in.
+         */
+        float integrator() const
+        {
+            if constexpr (std::is_same<Form, PositionalPID>::value)
+            {
+                return integral_;
+            }
+            else
+            {
+                return output_ + pending_ - last_feedforward_;
+            }
+        }
+
+        /**
+         * @brief Replace the integrated part of the output
+         *
+         * The output does not jump: the positional integrator is
+         * part of the next request, and the incremental form carries
+         * the difference as a pending change. Either way step() moves
+         * the output to it within the slew limit.
+         *
+         * @param value Value previously returned by integrator()
+         */
+        void loadIntegrator(float value)
+        {
+            if constexpr (std::is_same<Form, PositionalPID>::value)
+            {
+                integral_ = clamp(value, cfg_.out_min, cfg_.out_max);
+            }
+            else
+            {
+                pending_ = clamp(value + last_feedforward_, cfg_.out_min, cfg_.out_max) - output_;
+            }
+        }
+
+        /**
+         * @brief Run one control step
+         *
+         * @param setpoint Desired value
+         * @param measurement Measured value
+         * @param feedforward Open-loop contribution added to the output
+         * @return float New output in [out_min, out_max]
+         */
+        inline float step(float setpoint, float measurement, float feedforward = 0.0f)
+        {
+            const float error = setpoint - measurement;
+
+            // Derivative on measurement, first-order filtered
+            float d_raw = 0.0f;
+            if (primed_)
+            {
+                d_raw = -cfg_.kd * (measurement - last_measurement_) * inv_dt_;
+            }
+            else
+            {
+                last_error_ = error;
+            }
+            const float d_prev = d_term_;
+            d_term_ = d_alpha_ * d_term_ + (1.0f - d_alpha_) * d_raw;
+
+            float unsat;
+            if constexpr (std::is_same<Form, PositionalPID>::value)
+            {
+                terms_.p = cfg_.kp * error;
+                terms_.d = d_term_;
+                unsat = terms_.p + integral_ + terms_.d + feedforward;
+            }
+            else
+            {
+                terms_.p = cfg_.kp * (error - last_error_);
+                terms_.i = cfg_.ki * error * cfg_.dt;
+                terms_.d = d_term_ - d_prev;
+                unsat = output_ + pending_ + terms_.p + terms_.i + terms_.d + (feedforward - last_feedforward_);
+            }
+
+            float out = clamp(unsat, cfg_.out_min, cfg_.out_max);
+            if (max_step_ > 0.0f)
+            {
+                const float limited = clamp(out, output_ - max_step_, output_ + max_step_);
+                // Keep the part of a pending change the slew limit held back
+                const float left = out - limited;
+                pending_ = (pending_ > 0.0f) ? clamp(left, 0.0f, pending_) : clamp(left, pending_, 0.0f);
+                out = limited;
+            }
+            else
+            {
+                pending_ = 0.0f;
+            }
+
+            if constexpr (std::is_same<Form, PositionalPID>::value)
+            {
+                // Back-calculation: bleed the integrator by the part of the
+                // request that clamping and slew limiting did not deliver.
+                // The hard limit is the headroom the other terms leave, so
+                // a bumpless offset beyond the output range is kept.
+                terms_.i = integral_;
+                integral_ += (cfg_.ki * error + cfg_.kaw * (out - unsat)) * cfg_.dt;
+                const float others = terms_.p + terms_.d + feedforward;
+                integral_ = clamp(integral_, cfg_.out_min - others, cfg_.out_max - others);
+            }
+
+            output_ = out;
+            terms_.total = out;
+            last_measurement_ = measurement;
+            last_error_ = error;
+            last_feedforward_ = feedforward;
+            primed_ = true;
 
-#define PI_value 3.14159
-#define MAX_RPM 210.0
+            return out;
+        }
+
+        /**
+         * @brief Components of the last step
+         */
+        const PIDOutput& terms() const { return terms_; }
+
+        /**
+         * @brief Last output
+         */
+        float output() const { return output_; }
+
+        /**
+         * @brief Current configuration
+         */
+        const PIDConfig& config() const { return cfg_; }
+
+    private:
+
+        static inline float clamp(float value, float min, float max)
+        {
+            return (value > max) ? max : (value < min) ? min : value;
+        }
+
+        PIDConfig cfg_;             /**< Gains and limits */
+        float d_alpha_;             /**< D filter coefficient tau/(tau+dt) */
+        float inv_dt_;              /**< 1/dt, 0 when dt is 0 */
+        float max_step_;            /**< Slew limit per step, 0 = unlimited */
+        float integral_;            /**< Integral term in output units (positional form) */
+        float d_term_;              /**< Filtered derivative term */
+        float last_measurement_;    /**< Previous measurement (for derivative) */
+        float last_error_;          /**< Previous error (incremental P) */
+        float last_feedforward_;    /**< Previous feedforward (incremental FF) */
+        float output_;              /**< Last applied output */
+        float pending_;             /**< Loaded change not yet output (incremental) */
+        bool primed_;               /**< False until the first step after reset */
+        PIDOutput terms_;           /**< Components of the last step */
+};
+
+/**
+ * @class GainSchedule
+ * @brief PID gains interpolated linearly against |RPM|.
+ *
+ * Breakpoints are evenly spaced between rpm_min and rpm_max, so a
+ * lookup is one multiply and one interpolation, whatever the table
+ * size. Speeds outside the range use the end points.
+ */
+class GainSchedule
+{
+    public:
+
+        GainSchedule() : count_(0), rpm_min_(0.0f), inv_step_(0.0f) {}
+
+        /**
+         * @brief Load a table
+         *
+         * @param rpm_min Speed of the first point [RPM]
+         * @param rpm_max Speed of the last point [RPM]
+         * @param points Gains at evenly spaced speeds from rpm_min to rpm_max
+         * @param count Number of points, 1 to GAIN_SCHEDULE_MAX_POINTS
+         * @return false if the table is rejected (schedule left unchanged)
+         */
+        bool configure(float rpm_min, float rpm_max, const PIDGains* points, uint8_t count)
+        {
+            if (count == 0 || count > GAIN_SCHEDULE_MAX_POINTS || (count > 1 && !(rpm_max > rpm_min)))
+            {
+                return false;
+            }
+            for (uint8_t i = 0; i < count; i++)
+            {
+                points_[i] = points[i];
+            }
+            count_ = count;
+            rpm_min_ = rpm_min;
+            inv_step_ = (count > 1) ? (count - 1) / (rpm_max - rpm_min) : 0.0f;
+            return true;
+        }
+
+        /**
+         * @brief Disable the schedule
+         */
+        void clear() { count_ = 0; }
+
+        /**
+         * @brief True when a table is loaded
+         */
+        bool enabled() const { return count_ != 0; }
+
+        /**
+         * @brief Gains at a speed; call only when enabled()
+         *
+         * @param rpm Speed, either sign [RPM]
+         */
+        inline PIDGains lookup(float rpm) const
+        {
+            const float x = ((rpm < 0.0f ? -rpm : rpm) - rpm_min_) * inv_step_;
+            if (!(x > 0.0f))
+            {
+                return points_[0];
+            }
+            if (x >= count_ - 1)
+            {
+                return points_[count_ - 1];
+            }
+            const int i = static_cast<int>(x);
+            const float f = x - i;
+            const PIDGains& a = points_[i];
+            const PIDGains& b = points_[i + 1];
+            return PIDGains{a.kp + (b.kp - a.kp) * f, a.ki + (b.ki - a.ki) * f, a.kd + (b.kd - a.kd) * f};
+        }
+
+    private:
+
+        PIDGains points_[GAIN_SCHEDULE_MAX_POINTS];    /**< Gains at each breakpoint */
+        uint8_t count_;                                 /**< Points in use, 0 = disabled */
+        float rpm_min_;                                 /**< Speed of points_[0] */
+        float inv_step_;                                /**< 1 / breakpoint spacing */
+};
+
+#if PID_CONTROLLER_FORM == PID_FORM_POSITIONAL
+typedef PositionalPID MotorPIDForm;
+#elif PID_CONTROLLER_FORM == PID_FORM_INCREMENTAL
+typedef IncrementalPID MotorPIDForm;
+#else
+#error "Unknown PID_CONTROLLER_FORM"
+#endif
 
 /**
  * @class MotorPID
  * @brief Implements a PID controller for motor speed control.
  *
- * MotorPID calculates proportional, integral, and derivative terms
- * to generate a throttle value for controlling motor speed.
+ * MotorPID runs a PIDController<MotorPIDForm> in RPM units, limited to
+ * ±MAX_RPM, and converts its output to a throttle in [-1.0, 1.0].
+ *
+ * Setpoint and gain changes are bumpless. The integrator is kept per
+ * direction: reversing stores it for the old direction and restores the
+ * one last used in the new direction, so friction and load learnt for
+ * each direction are not unwound on every reversal.
  */
 class MotorPID
 {
@@ -30,30 +454,34 @@ class MotorPID
      * @struct PIDINPUT
      * @brief Structure for initializing MotorPID controller.
      */
-    typedef struct 
+    typedef struct
     {
         float kp;                    /**< Proportional gain */
-        float kd;                    /**< Integral component */
-        float ki;                    /**< Derivative component */
+        float ki;                    /**< Integral gain [1/s] */
+        float kd;                    /**< Derivative gain [s] */
         float dt;                    /**< Sample time (in seconds) */
         float expected_speed;        /**< Desired speed in RPM */
+        float kff;                   /**< Feedforward gain on the setpoint, 0 = none */
+        float d_filter_tau;          /**< D filter time constant (seconds), 0 = unfiltered */
+        float kaw;                   /**< Back-calculation anti-windup gain [1/s] */
+        float slew_rate;             /**< Maximum output change in RPM per second, 0 = unlimited */
     }PIDINPUT;
 
+    typedef ::PIDOutput PIDOutput;
+
     /**
-     * @struct PIDOutput
-     * @brief Structure holding PID calculation results.
+     * @enum ScheduleVariable
+     * @brief Speed the gain schedule is indexed with.
      */
-    typedef struct 
+    enum class ScheduleVariable : uint8_t
     {
-        float p;             /**< Proportional component */
-        float i;             /**< Integral component */
-        float d;             /**< Derivative component */
-        float total;         /**< Sum of P + I + D */
-    }PIDOutput;
+        MEASURED_RPM,       /**< Measured motor speed */
+        SETPOINT_RPM        /**< Target speed */
+    };
 
         /**
          * @brief Construct a new MotorPID object
-         * 
+         *
          * @param PIDIn Pointer to PIDINPUT structure containing gains, dt, and target speed
          */
         MotorPID(PIDINPUT * PIDIn);
@@ -63,19 +491,69 @@ class MotorPID
          */
         virtual ~MotorPID();
 
+        /**
+         * @brief Set a new target speed in radians per second.
+         *
+         * @param rps Desired angular velocity [rad/s]
+         * @param cw True for clockwise, false for counter-clockwise
+         */
+        void SetSpeedRadPSec(float rps, bool cw);
+
         /**
          * @brief Set a new target speed for the motor.
-         * 
+         *
+         * The output continues from its current value (no proportional
+         * kick); reversing swaps in the integrator of the new direction.
+         *
          * @param rpm Desired motor speed in RPM
          * @param cw True for clockwise, false for counter-clockwise
          */
         void SetSpeedRPM(float rpm, bool cw);
-        
+
+        /**
+         * @brief Stop the speed loop: zero target, output and integrators.
+         *
+         * Used after a supervisory cutoff, so re-enabling the motor does
+         * not resume from an output that wound up while it was stopped.
+         */
+        void Reset();
+
+        /**
+         * @brief Replace the PID gains, keeping controller state.
+         *
+         * Disables the gain schedule.
+         *
+         * @param kp Proportional gain
+         * @param ki Integral gain [1/s]
+         * @param kd Derivative gain [s]
+         */
+        void SetGains(float kp, float ki, float kd);
+
+        /**
+         * @brief Schedule the gains against speed.
+         *
+         * Gains are looked up and applied bumplessly on every step.
+         *
+         * @param variable Speed to index the table with
+         * @param rpm_min Speed of the first point [RPM]
+         * @param rpm_max Speed of the last point [RPM]
+         * @param points Gains at evenly spaced speeds
+         * @param count Number of points, 1 to GAIN_SCHEDULE_MAX_POINTS
+         * @return false if the table is rejected
+         */
+        bool SetGainSchedule(ScheduleVariable variable, float rpm_min, float rpm_max,
+                             const PIDGains* points, uint8_t count);
+
+        /**
+         * @brief Gains in use, scheduled ones included.
+         */
+        PIDGains GetGains() const;
+
         /**
          * @brief Update throttle based on measured motor speed
-         * 
-         * Calls ComputePID internally and applies the PID output to update throttle.
-         * 
+         *
+         * Calls ComputePID internally and scales the controller output to a throttle.
+         *
          * @param motor_speed Current motor speed in RPM
          * @return float New throttle value in range [-1.0, 1.0]
          */
@@ -83,38 +561,24 @@ class MotorPID
 
         /**
          * @brief Compute PID output based on current motor speed
-         * 
-         * Calculates P, I, and D components and returns a PIDOutput struct.
-         * 
+         *
+         * Runs one controller step and returns its components.
+         *
          * @param motor_speed Current motor speed in RPM
-         * @return PIDOutput PID calculation result
+         * @return PIDOutput PID calculation result, total in RPM units
          */
         PIDOutput ComputePID(float motor_speed);
 
     private:
 
-        /**
-         * @brief Clamp a value between min and max
-         * 
-         * @param value Value to clamp
-         * @param min Minimum allowed value
-         * @param max Maximum allowed value
-         * @return float Clamped value
-         */
-        float clamp(float value, float min, float max);
-
+        PIDController<MotorPIDForm> controller_;   /**< Compile-time selected controller */
         float target_RPM_;     /**< Target motor speed in RPM */
         bool clock_wise_;      /**< Motor rotation direction */
         float throttle_;       /**< Current throttle value [-1.0, 1.0] */
-        float dt_;             /**< Sample time (seconds) */
-        float kp_;             /**< Proportional gain */
-        float ki_;             /**< Integral gain */
-        float kd_;             /**< Derivative gain */
-        float error_;          /**< Current error (target - actual) */
-        float last_error_;     /**< Previous error (for derivative calculation) */
-        float error_sum_;      /**< Integral sum */
-        float integral_max_;   /**< Maximum allowed integral term */
-        float integral_min_;   /**< Minimum allowed integral term */
+        float kff_;            /**< Feedforward gain */
+        GainSchedule schedule_;                 /**< Speed-dependent gains */
+        ScheduleVariable schedule_variable_;    /**< Speed the schedule is indexed with */
+        float direction_integrator_[2];         /**< Stored integrator, [0] CCW, [1] CW */
 
 };
 
@@ -0,0 +1,37 @@
+#ifndef PID_CONFIG_HPP
+#define PID_CONFIG_HPP
+
+/**
+ * @file PID_config.hpp
+ * @brief Compile-time configuration of the motor speed controller.
+ *
+ * The controller form is selected here (or with -DPID_CONTROLLER_FORM=...)
+ * and resolved at compile time, so the control step has no virtual calls.
+ */
+
+/******************************************* Controller forms ******************************************** */
+#define PID_FORM_POSITIONAL   0   ///< u = P + I + D + FF
+#define PID_FORM_INCREMENTAL  1   ///< u += dP + dI + dD + dFF (velocity form)
+
+#ifndef PID_CONTROLLER_FORM
+#define PID_CONTROLLER_FORM PID_FORM_INCREMENTAL
+#endif
+
+/******************************************* Motor limits ******************************************** */
+#define PI_value 3.14159f       ///< Mathematical constant π
+#define MAX_RPM  210.0f         ///< Maximum motor speed, maps to full throttle
+
+/******************************************* Gain scheduling ******************************************** */
+#define GAIN_SCHEDULE_MAX_POINTS 8     ///< Breakpoints per gain table
+
+/******************************************* Default tuning ******************************************** */
+/* Used until a parameter block is stored in flash (see Params/param_store.hpp). Gains in RPM units. */
+#define MOTOR_PID_KP            0.0f    ///< Tune experimentally
+#define MOTOR_PID_KI            14.7f   ///< 0.007 throttle per RPM of error per 100ms
+#define MOTOR_PID_KD            0.0f
+#define MOTOR_PID_KFF           0.0f
+#define MOTOR_PID_D_FILTER_TAU  0.05f
+#define MOTOR_PID_KAW           10.0f
+#define MOTOR_PID_SLEW_RATE     0.0f
+
+#endif  /* PID_CONFIG_HPP */
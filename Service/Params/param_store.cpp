@@ -0,0 +1,196 @@
+/***************************************************************
+ *  File: param_store.cpp
+ *  Layer: Service Layer
+ *  Description:
+ *      - Wear-levelled parameter records on NvStorage.
+ ****************************************************************/
+
+#include "Params/param_store.hpp"
+#include "PID_config.hpp"
+#include <stddef.h>
+#include <string.h>
+
+// ---------------------------
+// CRC-32 (IEEE, reflected), table built at compile time
+// ---------------------------
+struct Crc32Table {
+    uint32_t entry[256];
+    constexpr Crc32Table() : entry() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1u) ? (c >> 1) ^ 0xEDB88320u : c >> 1;
+            entry[i] = c;
+        }
+    }
+};
+static constexpr Crc32Table crcTable;
+
+static uint32_t crc32(uint32_t crc, const void* data, uint32_t length) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    while (length--) crc = crcTable.entry[(crc ^ *p++) & 0xFFu] ^ (crc >> 8);
+    return ~crc;
+}
+
+static uint32_t recordCrc(const ParamHeader& header, const ParamBlock& block) {
+    uint32_t crc = crc32(0, &header, offsetof(ParamHeader, crc));
+    return crc32(crc, &block, sizeof(block));
+}
+
+// Wrap-safe "a is newer than b"
+static inline bool sequenceNewer(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) > 0;
+}
+
+// ---------------------------
+// Constructor
+// ---------------------------
+ParamStore::ParamStore(NvStorage& storage)
+    : _storage(storage), _sequence(0), _slot(-1) {
+    params_setDefaults(_block);
+}
+
+// ---------------------------
+// Static Method: params_setDefaults
+// ---------------------------
+void ParamStore::params_setDefaults(ParamBlock& block) {
+    memset(&block, 0, sizeof(block));
+    for (int i = 0; i < ENCODER_MAX_INSTANCES; i++) {
+        block.encoder[i].cpr = ENCODER_CPR;
+        block.encoder[i].wheelRadiusCm = WHEEL_RADIUS_CM;
+        block.encoder[i].inverted = 0;
+    }
+    for (int i = 0; i < PARAM_MOTOR_COUNT; i++) {
+        block.motor[i].kp = MOTOR_PID_KP;
+        block.motor[i].ki = MOTOR_PID_KI;
+        block.motor[i].kd = MOTOR_PID_KD;
+        block.motor[i].kff = MOTOR_PID_KFF;
+        block.motor[i].dFilterTau = MOTOR_PID_D_FILTER_TAU;
+        block.motor[i].kaw = MOTOR_PID_KAW;
+        block.motor[i].slewRate = MOTOR_PID_SLEW_RATE;
+    }
+}
+
+// ---------------------------
+// Method: readRecord
+// ---------------------------
+// Description:
+//     - True when the slot holds a complete record of this
+//       version with a matching CRC.
+bool ParamStore::readRecord(uint32_t slot, ParamHeader& header, ParamBlock& block) {
+    uint32_t offset = slot * PARAM_SLOT_SIZE;
+    if (!_storage.nv_read(offset, &header, sizeof(header))) {
+        return false;
+    }
+    if (header.magic != PARAM_MAGIC || header.version != PARAM_VERSION ||
+        header.length != sizeof(ParamBlock)) {
+        return false;
+    }
+    if (!_storage.nv_read(offset + sizeof(header), &block, sizeof(block))) {
+        return false;
+    }
+    return recordCrc(header, block) == header.crc;
+}
+
+// ---------------------------
+// Method: slotBlank
+// ---------------------------
+bool ParamStore::slotBlank(uint32_t slot) {
+    if (!_storage.nv_read(slot * PARAM_SLOT_SIZE, _buffer, PARAM_SLOT_SIZE)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < PARAM_SLOT_SIZE; i++) {
+        if (_buffer[i] != 0xFFu) return false;
+    }
+    return true;
+}
+
+// ---------------------------
+// Method: params_load
+// ---------------------------
+// Description:
+//     - Headers are checked first; only slots newer than the best
+//       so far are CRC-checked.
+bool ParamStore::params_load() {
+    uint32_t slots = _storage.nv_size() / PARAM_SLOT_SIZE;
+    ParamHeader header;
+    ParamBlock candidate;
+
+    for (uint32_t slot = 0; slot < slots; slot++) {
+        if (!_storage.nv_read(slot * PARAM_SLOT_SIZE, &header, sizeof(header)) ||
+            header.magic != PARAM_MAGIC) {
+            continue;
+        }
+        if (_slot >= 0 && !sequenceNewer(header.sequence, _sequence)) {
+            continue;
+        }
+        if (readRecord(slot, header, candidate)) {
+            _block = candidate;
+            _sequence = header.sequence;
+            _slot = static_cast<int32_t>(slot);
+        }
+    }
+    return _slot >= 0;
+}
+
+// ---------------------------
+// Method: params_save
+// ---------------------------
+// Description:
+//     - The target is the first slot after the newest record that
+//       is blank, or the start of the next erase block, which is
+//       erased first. Slots left half-written by a power cut are
+//       skipped until their sector is erased.
+bool ParamStore::params_save() {
+    uint32_t eraseSize = _storage.nv_eraseSize();
+    if (eraseSize == 0 || eraseSize % PARAM_SLOT_SIZE != 0 || _storage.nv_size() < 2 * eraseSize) {
+        return false;   // Needs two erase blocks to always keep one record
+    }
+    uint32_t slots = (_storage.nv_size() / eraseSize) * (eraseSize / PARAM_SLOT_SIZE);
+    uint32_t slotsPerBlock = eraseSize / PARAM_SLOT_SIZE;
+
+    uint32_t slot = (_slot < 0) ? 0 : (static_cast<uint32_t>(_slot) + 1) % slots;
+    for (;;) {
+        if (slot % slotsPerBlock == 0) {
+            if (!_storage.nv_erase(slot * PARAM_SLOT_SIZE, eraseSize)) {
+                return false;
+            }
+            break;
+        }
+        if (slotBlank(slot)) {
+            break;
+        }
+        slot = (slot + 1) % slots;
+    }
+
+    ParamHeader header;
+    header.magic = PARAM_MAGIC;
+    header.version = PARAM_VERSION;
+    header.length = sizeof(ParamBlock);
+    header.sequence = _sequence + 1;
+    header.crc = recordCrc(header, _block);
+
+    memset(_buffer, 0xFF, sizeof(_buffer));
+    memcpy(_buffer, &header, sizeof(header));
+    memcpy(_buffer + sizeof(header), &_block, sizeof(_block));
+    if (!_storage.nv_program(slot * PARAM_SLOT_SIZE, _buffer, PARAM_SLOT_SIZE)) {
+        return false;
+    }
+
+    // Verify: the slot is not reused before its sector is erased
+    ParamHeader check;
+    ParamBlock stored;
+    if (!readRecord(slot, check, stored) || check.sequence != header.sequence) {
+        return false;
+    }
+    _sequence = header.sequence;
+    _slot = static_cast<int32_t>(slot);
+    return true;
+}
+
+// ---------------------------
+// Getter Methods
+// ---------------------------
+ParamBlock& ParamStore::params_get() { return _block; }
+
+uint32_t ParamStore::params_getSequence() const { return _sequence; }
@@ -0,0 +1,137 @@
+#ifndef PARAM_STORE_HPP
+#define PARAM_STORE_HPP
+
+#include <stdint.h>
+#include "Flash/nv_storage.hpp"
+#include "Encoder/encoder_config.hpp"
+
+/***************************************************************
+ * Parameter Record Layout
+ * Description:
+ *     - The storage region is divided into PARAM_SLOT_SIZE slots
+ *       (one flash page). Every save programs the next slot, so
+ *       each slot is written once per erase of its sector.
+ *     - A slot holds a ParamHeader followed by a ParamBlock.
+ *       The CRC-32 covers the header fields before it and the
+ *       block. The valid slot with the highest sequence wins.
+ *     - A new sector is erased only when writing moves into it;
+ *       the newest record sits in the other sector until the new
+ *       one is programmed, so a power cut never loses both.
+ *     - Any change to ParamBlock must bump PARAM_VERSION: records
+ *       of another version are ignored and defaults are used.
+ ****************************************************************/
+#define PARAM_MAGIC         0x314D5250u     // "PRM1"
+#define PARAM_VERSION       1
+#define PARAM_SLOT_SIZE     256
+#define PARAM_MOTOR_COUNT   1
+
+struct ParamHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;        // sizeof(ParamBlock)
+    uint32_t sequence;      // Incremented by every save
+    uint32_t crc;
+};
+
+/***************************************************************
+ * Struct: EncoderParams / MotorParams / ParamBlock
+ * Description:
+ *     - Calibration of each encoder and tuning of each motor
+ *       speed controller (see MotorPID::PIDINPUT).
+ ****************************************************************/
+struct EncoderParams {
+    uint32_t cpr;               // Counts per wheel revolution
+    float wheelRadiusCm;
+    uint8_t inverted;           // 1 = counts backwards for forward motion
+    uint8_t reserved[3];
+};
+
+struct MotorParams {
+    float kp;
+    float ki;
+    float kd;
+    float kff;
+    float dFilterTau;
+    float kaw;
+    float slewRate;
+};
+
+struct ParamBlock {
+    EncoderParams encoder[ENCODER_MAX_INSTANCES];
+    MotorParams motor[PARAM_MOTOR_COUNT];
+};
+
+static_assert(sizeof(ParamHeader) + sizeof(ParamBlock) <= PARAM_SLOT_SIZE,
+              "ParamBlock does not fit in one slot");
+
+/***************************************************************
+ * Class: ParamStore
+ * Layer: Service Layer
+ * Description:
+ *     - Versioned, CRC-protected, wear-levelled parameter block
+ *       on an NvStorage region of at least two erase blocks.
+ *     - params_load() only reads slot headers and the CRC of
+ *       candidates: it completes in microseconds from XIP flash.
+ ****************************************************************/
+class ParamStore {
+public:
+    /***********************************************************
+     * Constructor: ParamStore
+     * Description:
+     *     - Starts with default parameters; call params_load().
+     ***********************************************************/
+    ParamStore(NvStorage& storage);
+
+    /***********************************************************
+     * Method: params_load
+     * Description:
+     *     - Loads the newest valid record. Returns false and keeps
+     *       the defaults when there is none.
+     ***********************************************************/
+    bool params_load();
+
+    /***********************************************************
+     * Method: params_save
+     * Description:
+     *     - Writes the current block as a new record and reads it
+     *       back. Returns false if it could not be stored; the
+     *       previous record stays valid.
+     *     - May erase a sector: see the storage's blocking notes.
+     ***********************************************************/
+    bool params_save();
+
+    /***********************************************************
+     * Method: params_get
+     * Description:
+     *     - The working copy; changes are kept by params_save().
+     ***********************************************************/
+    ParamBlock& params_get();
+
+    /***********************************************************
+     * Method: params_getSequence
+     * Description:
+     *     - Sequence of the loaded or last saved record, 0 when
+     *       running on defaults.
+     ***********************************************************/
+    uint32_t params_getSequence() const;
+
+    /***********************************************************
+     * Static Method: params_setDefaults
+     * Description:
+     *     - Compile-time defaults (encoder_config.hpp and the
+     *       application's tuning).
+     ***********************************************************/
+    static void params_setDefaults(ParamBlock& block);
+
+private:
+    bool readRecord(uint32_t slot, ParamHeader& header, ParamBlock& block);
+    bool slotBlank(uint32_t slot);
+
+    NvStorage& _storage;
+    ParamBlock _block;                  // Working copy
+    uint32_t _sequence;                 // Newest stored sequence
+    int32_t _slot;                      // Slot of the newest record, -1 none
+    uint8_t _buffer[PARAM_SLOT_SIZE];   // One slot, for blank checks and writes
+};
+
+#endif